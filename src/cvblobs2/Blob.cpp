@@ -5,17 +5,21 @@
  */
 #include <cvblobs2/Blob.h>
 #include <cvblobs2/BlobContour.h>
-#include <cvblobs2/BlobOperators.h>
+#include <cvblobs2/ConvexHull.h>
 
 CVBLOBS_BEGIN_NAMESPACE
 
 Blob::Blob()
     : mpExternalContour(new BlobContour()),
       mInternalContours(),
+      mJoinedContours(),
+      mConvexHull(),
+      mbConvexHullComputed(false),
       mProperties(),
       mId(0),
       mOriginalImageSize(std::numeric_limits<cv::Point::value_type>::min(),
-                         std::numeric_limits<cv::Point::value_type>::min())
+                         std::numeric_limits<cv::Point::value_type>::min()),
+      mPixelMoments()
 {}
 
 Blob::Blob(LabelType id,
@@ -23,17 +27,39 @@ Blob::Blob(LabelType id,
            const cv::Size& originalImageSize)
     : mpExternalContour(new BlobContour(startPoint)),
       mInternalContours(),
+      mJoinedContours(),
+      mConvexHull(),
+      mbConvexHullComputed(false),
       mProperties(),
       mId(id),
-      mOriginalImageSize(originalImageSize)
+      mOriginalImageSize(originalImageSize),
+      mPixelMoments()
+{}
+
+Blob::Blob(LabelType id,
+           cv::Ptr<BlobContour> pExternalContour,
+           const cv::Size& originalImageSize)
+    : mpExternalContour(pExternalContour),
+      mInternalContours(),
+      mJoinedContours(),
+      mConvexHull(),
+      mbConvexHullComputed(false),
+      mProperties(),
+      mId(id),
+      mOriginalImageSize(originalImageSize),
+      mPixelMoments()
 {}
 
 Blob::Blob(const Blob& source)
     : mpExternalContour(source.mpExternalContour),
       mInternalContours(source.mInternalContours),
+      mJoinedContours(source.mJoinedContours),
+      mConvexHull(source.mConvexHull),
+      mbConvexHullComputed(source.mbConvexHullComputed),
       mProperties(source.mProperties),
       mId(source.mId),
-      mOriginalImageSize(source.mOriginalImageSize)
+      mOriginalImageSize(source.mOriginalImageSize),
+      mPixelMoments(source.mPixelMoments)
 {}
 
 Blob::~Blob()
@@ -57,23 +83,27 @@ void Blob::swap(Blob& other)
 {
   std::swap(mpExternalContour,  other.mpExternalContour);
   std::swap(mInternalContours,  other.mInternalContours);
-  std::swap(mProperties,        other.mProperties);
+  std::swap(mJoinedContours,    other.mJoinedContours);
+  mConvexHull.swap(other.mConvexHull);
+  std::swap(mbConvexHullComputed, other.mbConvexHullComputed);
+  mProperties.swap(other.mProperties);
   std::swap(mId,                other.mId);
   std::swap(mOriginalImageSize, other.mOriginalImageSize);
+  std::swap(mPixelMoments,      other.mPixelMoments);
 }
 
 void Blob::clear()
 {
-  ContourContainerType::iterator end_iter = mInternalContours.end();
-	for (ContourContainerType::iterator iter = mInternalContours.begin();
-       iter != end_iter;
-       ++iter)
-	{
-		(*iter)->clear();
-	}	
+  // the contours can be shared with copies of this blob, and with the blobs
+  // joined into it or it was joined into (see joinBlob()), so they are
+  // released rather than cleared
 	mInternalContours.clear();
-	mpExternalContour->clear();
+	mpExternalContour = new BlobContour(mpExternalContour->startPoint());
+  mJoinedContours.clear();
+  mConvexHull.clear();
+  mbConvexHullComputed = false;
   mProperties.clear();
+  mPixelMoments = PixelMoments();
 }
 
 void Blob::addInternalContour(cv::Ptr<BlobContour> pInternalContour)
@@ -103,9 +133,22 @@ bool Blob::isEmpty()
 */
 double Blob::area()
 {
+  if (hasPixelMoments())
+  {
+    return mPixelMoments.area();
+  }
+
   // total area of external contour
 	double area = mpExternalContour->area();
 
+  // plus the joined blobs
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+		area += (*iter)->area();
+	}
+
   // minus all of the internal contours
   ContourContainerType::iterator end_iter = mInternalContours.end();
 	for (ContourContainerType::iterator iter = mInternalContours.begin();
@@ -135,6 +178,14 @@ double Blob::perimeter()
   // perimeter of external contour
 	double perimeter = mpExternalContour->perimeter();
 
+  // plus the joined blobs
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+		perimeter += (*iter)->perimeter();
+	}
+
   // plus perimeter of all internal contours
   ContourContainerType::iterator end_iter = mInternalContours.end();
 	for (ContourContainerType::iterator iter = mInternalContours.begin();
@@ -200,14 +251,37 @@ double Blob::externPerimeter(cv::Mat& mask,
                              bool bXBorderRight  /* = true */,
                              bool bYBorderTop    /* = true */,
                              bool bYBorderBottom /* = true */)
+{
+  double extern_perimeter = contourExternPerimeter(
+      mpExternalContour->contourPoints(),
+      mask,
+      bXBorderLeft, bXBorderRight,
+      bYBorderTop,  bYBorderBottom);
+
+  // plus the joined blobs
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+    extern_perimeter += contourExternPerimeter((*iter)->contourPoints(),
+                                               mask,
+                                               bXBorderLeft, bXBorderRight,
+                                               bYBorderTop,  bYBorderBottom);
+	}
+  return extern_perimeter;
+}
+
+double Blob::contourExternPerimeter(const PointContainerType& extern_contour,
+                                    cv::Mat& mask,
+                                    bool bXBorderLeft,
+                                    bool bXBorderRight,
+                                    bool bYBorderTop,
+                                    bool bYBorderBottom)
 {
   cv::Point previous_point;
 	bool find = false;
 	int delta = 0;
 	double extern_perimeter = 0.0;
-	
-	// get contour pixels
-	const PointContainerType& extern_contour = mpExternalContour->contourPoints();
 
 	// there are contour pixels?
 	if (extern_contour.empty())
@@ -333,9 +407,22 @@ double Blob::externPerimeter(cv::Mat& mask,
 //! Compute blob's moment (p,q up to MAX_CALCULATED_MOMENTS)
 double Blob::moment(int p, int q)
 {
+  if (hasPixelMoments())
+  {
+    return mPixelMoments.moment(p, q);
+  }
+
   // external moment
 	double moment = mpExternalContour->moment(p,q);
 
+  // plus the joined blobs
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+		moment += (*iter)->moment(p,q);
+	}
+
   // minus all of the internal moments
 	ContourContainerType::iterator end_iter = mInternalContours.end();
 	for (ContourContainerType::iterator iter = mInternalContours.begin();
@@ -421,6 +508,23 @@ void Blob::meanAndStdDev(cv::Mat& image, double& mean, double& stddev)
                    0,             // draw only the specified contour
                    offset);       // offset to shift each point
 
+	// draw joined contours
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+    contours[0] = cv::Mat((*iter)->contourPoints(), false);
+    cv::drawContours(mask,
+                     contours,
+                     -1, // draw all contours
+                     cv::Scalar(255, 255, 255), // fill color
+                     CV_FILLED,     // thickness
+                     8,             // line type
+                     cv::noArray(), // heirarchy
+                     0,             // draw only the specified contour
+                     offset);       // offset to shift each point
+	}
+
 	// draw internal contours
   ContourContainerType::iterator end_iter = mInternalContours.end();
 	for (ContourContainerType::iterator iter = mInternalContours.begin();
@@ -466,7 +570,42 @@ void Blob::meanAndStdDev(cv::Mat& image, double& mean, double& stddev)
 */
 cv::Rect Blob::boundingBox()
 {
-	return mpExternalContour->boundingBox();
+  if (hasPixelMoments())
+  {
+    return mPixelMoments.boundingBox();
+  }
+
+  // union with the boxes of the joined blobs that aren't empty
+  cv::Rect bounding_box = mpExternalContour->boundingBox();
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter)
+	{
+    const cv::Rect joined_box = (*iter)->boundingBox();
+    if (joined_box.width <= 0 || joined_box.height <= 0)
+    {
+      continue;
+    }
+    if (bounding_box.width <= 0 || bounding_box.height <= 0)
+    {
+      bounding_box = joined_box;
+      continue;
+    }
+    const int min_x = std::min(bounding_box.x, joined_box.x);
+    const int min_y = std::min(bounding_box.y, joined_box.y);
+    bounding_box.width = std::max(bounding_box.x + bounding_box.width,
+                                  joined_box.x + joined_box.width) - min_x;
+    bounding_box.height = std::max(bounding_box.y + bounding_box.height,
+                                   joined_box.y + joined_box.height) - min_y;
+    bounding_box.x = min_x;
+    bounding_box.y = min_y;
+	}
+	return bounding_box;
+}
+
+void Blob::setPixelMoments(const PixelMoments& pixelMoments)
+{
+  mPixelMoments = pixelMoments;
 }
 
 /**
@@ -495,23 +634,29 @@ cv::RotatedRect Blob::ellipse()
   double delta;
   double temp;
 
-	// it is calculated?
-	if (mProperties.find(BlobGetMajorAxisLength().name()) != mProperties.end())
+	// it is calculated? The five properties are always set together
+  double value;
+	if (mProperties.find(PROPERTY_MAJOR_AXIS_LENGTH, value))
 	{
 		// build a ellipse from calculated properties
-		elipse.size.width = mProperties[BlobGetMajorAxisLength().name()];
-		elipse.size.height = mProperties[BlobGetMinorAxisLength().name()];
-		elipse.angle = mProperties[BlobGetOrientation().name()];
-		elipse.center.x = mProperties[BlobGetElipseXCenter().name()];
-		elipse.center.y = mProperties[BlobGetElipseYCenter().name()];
+		elipse.size.width = value;
+		mProperties.find(PROPERTY_MINOR_AXIS_LENGTH, value);
+		elipse.size.height = value;
+		mProperties.find(PROPERTY_ORIENTATION, value);
+		elipse.angle = value;
+		mProperties.find(PROPERTY_ELIPSE_X_CENTER, value);
+		elipse.center.x = value;
+		mProperties.find(PROPERTY_ELIPSE_Y_CENTER, value);
+		elipse.center.y = value;
+    return elipse;
 	}	
 
 	// initialize properties
-	mProperties[BlobGetMajorAxisLength().name()] = 0;
-	mProperties[BlobGetMinorAxisLength().name()] = 0;
-	mProperties[BlobGetOrientation().name()] = 0;
-	mProperties[BlobGetElipseXCenter().name()] = 0;
-	mProperties[BlobGetElipseYCenter().name()] = 0;
+	mProperties.set(PROPERTY_MAJOR_AXIS_LENGTH, 0);
+	mProperties.set(PROPERTY_MINOR_AXIS_LENGTH, 0);
+	mProperties.set(PROPERTY_ORIENTATION, 0);
+	mProperties.set(PROPERTY_ELIPSE_X_CENTER, 0);
+	mProperties.set(PROPERTY_ELIPSE_Y_CENTER, 0);
 	elipse.angle = 0;
 	elipse.size.height = 0;
 	elipse.size.width = 0;
@@ -540,14 +685,14 @@ cv::RotatedRect Blob::ellipse()
 	elipse.center.x = u10;
 	elipse.center.y = u01;
 
-	mProperties[BlobGetElipseXCenter().name()] = elipse.center.x;
-	mProperties[BlobGetElipseYCenter().name()] = elipse.center.y;
+	mProperties.set(PROPERTY_ELIPSE_X_CENTER, elipse.center.x);
+	mProperties.set(PROPERTY_ELIPSE_Y_CENTER, elipse.center.y);
 	
 	temp = u20 + u02 + delta;
 	if (temp > 0)
 	{
 		elipse.size.width = sqrt( 2*(u20 + u02 + delta ));
-		mProperties[BlobGetMajorAxisLength().name()] = elipse.size.width;
+		mProperties.set(PROPERTY_MAJOR_AXIS_LENGTH, elipse.size.width);
 	}	
 	else
 	{
@@ -558,7 +703,7 @@ cv::RotatedRect Blob::ellipse()
 	if( temp > 0 )
 	{
 		elipse.size.height = sqrt( 2*(u20 + u02 - delta ) );
-		mProperties[BlobGetMinorAxisLength().name()] = elipse.size.height;
+		mProperties.set(PROPERTY_MINOR_AXIS_LENGTH, elipse.size.height);
 	}
 	else
 	{
@@ -576,7 +721,7 @@ cv::RotatedRect Blob::ellipse()
 	// convert to degrees
 	elipse.angle = (180.0 / CV_PI) *elipse.angle;
 	elipse.angle += 180;
-	mProperties[BlobGetOrientation().name()] = elipse.angle;
+	mProperties.set(PROPERTY_ORIENTATION, elipse.angle);
 
 	return elipse;
 }
@@ -599,8 +744,16 @@ void Blob::fillBlob(cv::Mat& image, const cv::Scalar& color)
 {
   const PointContainerType& contour_points = mpExternalContour->contourPoints();
   
-  std::vector<cv::Mat> contours(1);
+  // the external contour and the ones of the joined blobs
+  std::vector<cv::Mat> contours(1 + mJoinedContours.size());
   contours[0] = cv::Mat(contour_points, false);
+  std::size_t i = 1;
+	for (ContourContainerType::iterator iter = mJoinedContours.begin();
+       iter != mJoinedContours.end();
+       ++iter, ++i)
+	{
+    contours[i] = cv::Mat((*iter)->contourPoints(), false);
+	}
   cv::drawContours(image,
                    contours,
                    -1,            // draw all contours
@@ -626,35 +779,84 @@ void Blob::fillBlob(cv::Mat& image, const cv::Scalar& color)
 */
 void Blob::convexHull(PointContainerType& hull)
 {
-  const PointContainerType& contour_points = mpExternalContour->contourPoints();
-	if (contour_points.empty())
+  hull = convexHull();
+}
+
+const PointContainerType& Blob::convexHull()
+{
+  if (mbConvexHullComputed)
   {
-    cv::convexHull(contour_points,
-                   hull,
-                   true);  // clockwise?
+    return mConvexHull;
   }
+
+  contourConvexHull(mpExternalContour->contourPoints(), mConvexHull);
+  if (!mJoinedContours.empty())
+  {
+    // the hull of the union is the hull of the hulls of the contours
+    PointContainerType hull_points(mConvexHull);
+    PointContainerType joined_hull;
+    for (ContourContainerType::iterator iter = mJoinedContours.begin();
+         iter != mJoinedContours.end();
+         ++iter)
+    {
+      contourConvexHull((*iter)->contourPoints(), joined_hull);
+      hull_points.insert(hull_points.end(),
+                         joined_hull.begin(),
+                         joined_hull.end());
+    }
+    mConvexHull.clear();
+    if (!hull_points.empty())
+    {
+      cv::convexHull(hull_points,
+                     mConvexHull,
+                     true);  // clockwise
+    }
+  }
+  mbConvexHullComputed = true;
+  return mConvexHull;
 }
 
 /**
    - FUNCTION: JoinBlob
-   - FUNCTIONALITY: Add's external contour to current external contour
+   - FUNCTIONALITY: Makes blob part of the current blob
    - PARAMETERS:
-   - blob: blob from which extract the added external contour
+   - blob: blob whose contours are added
    - RESULT:
-   - true if no error ocurred
-   - RESTRICTIONS: Only external contours are added
+   - RESTRICTIONS: the blobs don't share any pixel
    - AUTHOR: Ricard Borrs
    - CREATION DATE: 25-05-2005.
    - MODIFICATION: Date. Author. Description.
 */
 void Blob::joinBlob(const Blob& blob)
 {
-  // @todo proper set join implementation
-  ChainCodeContainerType& contour = mpExternalContour->mContour;
-  const ChainCodeContainerType& src_contour = blob.mpExternalContour->mContour;
-  contour.insert(contour.end(), src_contour.begin(), src_contour.end());
+  if (&blob == this)
+  {
+    return;
+  }
+
+  // the external contours of blob become joined contours, its holes are
+  // holes of the union
+  mJoinedContours.push_back(blob.mpExternalContour);
+  mJoinedContours.insert(mJoinedContours.end(),
+                         blob.mJoinedContours.begin(),
+                         blob.mJoinedContours.end());
+  mInternalContours.insert(mInternalContours.end(),
+                           blob.mInternalContours.begin(),
+                           blob.mInternalContours.end());
+
+  // pixel moments are additive, keep them only if both blobs have them
+  if (hasPixelMoments() && blob.hasPixelMoments())
+  {
+    mPixelMoments.add(blob.mPixelMoments);
+  }
+  else
+  {
+    mPixelMoments = PixelMoments();
+  }
 
 	// reset stats for the blob
+  mConvexHull.clear();
+  mbConvexHullComputed = false;
 	mProperties.clear();
 }
 
@@ -2,7 +2,6 @@
 #define _CVBLOBS2_BLOB_H_
 
 // std
-#include <map>
 #include <string>
 
 // opencv
@@ -10,7 +9,9 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 // cvblobs
+#include <cvblobs2/BlobProperties.h>
 #include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/SpatialMoments.h>
 
 CVBLOBS_BEGIN_NAMESPACE
 
@@ -24,9 +25,14 @@ CVBLOBS_BEGIN_NAMESPACE
  */
 class Blob
 {
+  //! recycles the storage of the contour lists
+  friend class BlobArena;
+
  public:
-	//! Type of blob properties: a map with variant types
-	typedef std::map<std::string, double> PropertiesType;
+	//! Type of blob properties: slots of the built-in operators and a map
+	//! for the others. It was a std::map<std::string, double>, see
+	//! BlobProperties for the functions that replace the map ones.
+	typedef BlobProperties PropertiesType;
 
   /** 
    * @brief Creates an empty blob.
@@ -45,6 +51,18 @@ class Blob
        const cv::Point& startPoint,
        const cv::Size& originalImageSize);
 
+  /**
+   * @brief Creates a new blob with an identifier of \p id whose external
+   * contour is \p pExternalContour, used by BlobArena to create the contour
+   * in the arena as well
+   * @param id 
+   * @param pExternalContour must not be NULL
+   * @param originalImageSize 
+   */
+	Blob(LabelType id,
+       cv::Ptr<BlobContour> pExternalContour,
+       const cv::Size& originalImageSize);
+
   /** 
    * @brief Destroys a blob and all of its contours
    */
@@ -77,6 +95,18 @@ class Blob
    * If \p i is >= numInternalContours() then NULL is returned.
    */
   inline cv::Ptr<BlobContour> internalContour(std::size_t i) const;
+
+  /**
+   * @brief Returns the number of external contours of other blobs joined to
+   * this one with joinBlob()
+   */
+  inline std::size_t numJoinedContours() const;
+
+  /**
+   * @brief Returns the external contour of a joined blob at index \p i, or
+   * NULL if \p i is >= numJoinedContours()
+   */
+  inline cv::Ptr<BlobContour> joinedContour(std::size_t i) const;
   
   
 	//! Retrieves an internal contour in Freeman's chain code at index i
@@ -93,6 +123,8 @@ class Blob
                bool yBorderBottom = true);
   
 	//! Compute blob's area
+	//! The pixel count when the blob has pixel moments, else the area of the
+	//! contours
 	double area();
   
 	//! Compute blob's perimeter
@@ -128,15 +160,52 @@ class Blob
 	//! Calculates the convex hull of the blob
 	void convexHull(PointContainerType& hull);
 
+  /**
+   * @brief Returns the convex hull of the external and joined contours,
+   * clockwise like cv::convexHull(points, hull, true).
+   * It is computed in linear time (see contourConvexHull()) the first time
+   * it is asked for, then kept until the contours change with joinBlob() or
+   * clear(), so the hull based operators share it.
+   */
+  const PointContainerType& convexHull();
+
 	//! Pinta l'interior d'un blob d'un color determinat
 	//! Paints the blob in an image
 	void fillBlob(cv::Mat& image, const cv::Scalar& color);
 
-	//! Join a blob to current one (add's contour
+  /**
+   * @brief Makes \p blob part of this blob. Its external contour, and the
+   * ones it had joined, become joined contours of this blob and its internal
+   * contours become internal contours of this blob. The contours are shared,
+   * not modified.
+   * Area, perimeter, moments and bounding box are then the ones of the union
+   * of the two blobs, the contour properties being additive: the sum over
+   * the external and joined contours minus the internal ones. The pixel
+   * moments are added if both blobs have them, dropped otherwise.
+   * @pre \p blob doesn't share any pixel with this blob
+   */
 	void joinBlob(const Blob& blob);
 
 	//! Get bounding box
   cv::Rect boundingBox();
+
+  /**
+   * @brief Sets the moments of the pixels of the blob, accumulated by
+   * ComponentLabeling() with LABELING_ACCUMULATE_MOMENTS.
+   * Once set, area(), moment() and boundingBox() return them instead of
+   * computing them from the contours.
+   */
+  void setPixelMoments(const PixelMoments& pixelMoments);
+
+  /**
+   * @brief Returns true if the blob has pixel moments
+   */
+  inline bool hasPixelMoments() const;
+
+  /**
+   * @brief Returns the pixel moments of the blob, empty if there are none
+   */
+  inline const PixelMoments& pixelMoments() const;
   
 	//! Get bounding ellipse
   cv::RotatedRect ellipse();
@@ -162,11 +231,22 @@ class Blob
 	//! Calculates mean and std deviation of blob in input image
 	void meanAndStdDev(cv::Mat& image, double& mean, double& stdDev);
 	
-	//! Deallocates all contours
+	//! Releases all contours, the external one is replaced by an empty
+	//! contour at the same start point. Other blobs sharing the contours
+	//! keep them.
 	void clear();
   
  private:
 
+  //! Extern perimeter of the contour whose points are \p externContour, see
+  //! externPerimeter()
+  double contourExternPerimeter(const PointContainerType& externContour,
+                                cv::Mat& mask,
+                                bool bXBorderLeft,
+                                bool bXBorderRight,
+                                bool bYBorderTop,
+                                bool bYBorderBottom);
+
   // sort points top-to-bottom left-to-right order
   // y is compared before x for strict ordering
   // lhs is above rhs if lhs.y < rhs.y
@@ -199,6 +279,14 @@ class Blob
 	//! Internal contours (crack codes)
 	ContourContainerType mInternalContours;
 
+  //! External contours of the blobs joined to this one
+  ContourContainerType mJoinedContours;
+
+  //! Convex hull of the external and joined contours, valid if
+  //! mbConvexHullComputed
+  PointContainerType mConvexHull;
+  bool mbConvexHullComputed;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Blob features
 	//////////////////////////////////////////////////////////////////////////
@@ -211,6 +299,9 @@ class Blob
   
 	//! Sizes from image where blob is extracted
   cv::Size mOriginalImageSize;
+
+  //! Moments of the pixels, empty unless accumulated during the labeling
+  PixelMoments mPixelMoments;
 };
 
 inline cv::Ptr<BlobContour> Blob::externalContour()
@@ -218,11 +309,49 @@ inline cv::Ptr<BlobContour> Blob::externalContour()
   return mpExternalContour;
 }
 
+inline std::size_t Blob::numInternalContours() const
+{
+  return mInternalContours.size();
+}
+
+inline cv::Ptr<BlobContour> Blob::internalContour(std::size_t i) const
+{
+  if (i >= mInternalContours.size())
+  {
+    return NULL;
+  }
+  return mInternalContours[i];
+}
+
+inline std::size_t Blob::numJoinedContours() const
+{
+  return mJoinedContours.size();
+}
+
+inline cv::Ptr<BlobContour> Blob::joinedContour(std::size_t i) const
+{
+  if (i >= mJoinedContours.size())
+  {
+    return NULL;
+  }
+  return mJoinedContours[i];
+}
+
 inline LabelType Blob::id() const
 {
   return mId;
 }
 
+inline bool Blob::hasPixelMoments() const
+{
+  return !mPixelMoments.isEmpty();
+}
+
+inline const PixelMoments& Blob::pixelMoments() const
+{
+  return mPixelMoments;
+}
+
 inline double Blob::minX()
 {
   return boundingBox().x;
@@ -250,7 +379,7 @@ inline Blob::PropertiesType* Blob::properties()
 
 inline void Blob::resetProperty(const std::string& propertyName)
 {
-  mProperties.erase(propertyName);
+  mProperties.reset(propertyName);
 }
 
 CVBLOBS_END_NAMESPACE
@@ -0,0 +1,189 @@
+#include <cvblobs2/BlobArena.h>
+
+#include <algorithm>
+#include <new>
+
+#include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobContour.h>
+
+// adoptPtr() sets the members of the cv::Ptr of OpenCV 2.x, which OpenCV 3
+// replaced
+#if !defined(CV_MAJOR_VERSION) || CV_MAJOR_VERSION != 2
+#  error "BlobArena only supports the cv::Ptr of OpenCV 2.x"
+#endif
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! alignment of every allocation, enough for the doubles of the objects
+const std::size_t ARENA_ALIGNMENT = 16;
+
+inline std::size_t ALIGN_SIZE(std::size_t size)
+{
+  return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Returns a cv::Ptr to \p pObject counted by \p pRefcount, which must
+ * already count the returned reference.
+ * The cv::Ptr of OpenCV 2.x always allocates its own reference count and
+ * deletes the object with the last reference, it can't be told about an
+ * object of the arena. So its public members are set directly; this is the
+ * only place that relies on them.
+ */
+template <typename T>
+inline cv::Ptr<T> adoptPtr(T* pObject, int* pRefcount)
+{
+  cv::Ptr<T> ptr;
+  ptr.obj = pObject;
+  ptr.refcount = pRefcount;
+  return ptr;
+}
+
+} // end anonymous namespace
+
+BlobArena::BlobArena(std::size_t blockSize /* = 64 * 1024 */)
+    : mBlockSize(ALIGN_SIZE(blockSize)),
+      mBlocks(),
+      mBlockSizes(),
+      mCurrentBlock(0),
+      mCurrentOffset(0),
+      mBlobs(),
+      mContours(),
+      mFreeChainCodes(),
+      mFreeContourLists()
+{}
+
+BlobArena::~BlobArena()
+{
+  release();
+}
+
+cv::Ptr<Blob> BlobArena::createBlob(LabelType id,
+                                    const cv::Point& startPoint,
+                                    const cv::Size& originalImageSize)
+{
+  cv::Ptr<BlobContour> p_external_contour = createContour(startPoint);
+  Blob* p_blob = new (allocate(sizeof(Blob))) Blob(id,
+                                                   p_external_contour,
+                                                   originalImageSize);
+  reuse(p_blob->mInternalContours, mFreeContourLists);
+  reuse(p_blob->mJoinedContours, mFreeContourLists);
+  return share(p_blob, mBlobs);
+}
+
+cv::Ptr<BlobContour> BlobArena::createContour(const cv::Point& startPoint)
+{
+  BlobContour* p_contour =
+      new (allocate(sizeof(BlobContour))) BlobContour(startPoint);
+  reuse(p_contour->mContour, mFreeChainCodes);
+  return share(p_contour, mContours);
+}
+
+void BlobArena::clear()
+{
+  // only the reference of the arena may be left. A cv::Ptr still held
+  // would point to a destroyed object without noticing, so this is checked
+  // in release builds too, before the objects are destroyed.
+  for (std::size_t i = 0; i < mBlobs.size(); ++i)
+  {
+    CV_Assert(*mBlobs[i].pRefcount == 1);
+  }
+  // the blobs release their contours, destroy them first. The pools are
+  // grown once beforehand, the copies made by a growing vector don't keep
+  // the storage.
+  mFreeContourLists.reserve(mFreeContourLists.size() + 2 * mBlobs.size());
+  for (std::size_t i = 0; i < mBlobs.size(); ++i)
+  {
+    Blob* p_blob = mBlobs[i].pObject;
+    recycle(p_blob->mInternalContours, mFreeContourLists);
+    recycle(p_blob->mJoinedContours, mFreeContourLists);
+    p_blob->~Blob();
+  }
+  mBlobs.clear();
+  for (std::size_t i = 0; i < mContours.size(); ++i)
+  {
+    CV_Assert(*mContours[i].pRefcount == 1);
+  }
+  mFreeChainCodes.reserve(mFreeChainCodes.size() + mContours.size());
+  for (std::size_t i = 0; i < mContours.size(); ++i)
+  {
+    BlobContour* p_contour = mContours[i].pObject;
+    recycle(p_contour->mContour, mFreeChainCodes);
+    p_contour->~BlobContour();
+  }
+  mContours.clear();
+
+  mCurrentBlock = 0;
+  mCurrentOffset = 0;
+}
+
+void BlobArena::release()
+{
+  clear();
+  for (std::size_t i = 0; i < mBlocks.size(); ++i)
+  {
+    delete [] mBlocks[i];
+  }
+  mBlocks.clear();
+  mBlockSizes.clear();
+  std::vector<ChainCodeContainer>().swap(mFreeChainCodes);
+  std::vector<ContourContainerType>().swap(mFreeContourLists);
+}
+
+void* BlobArena::allocate(std::size_t size)
+{
+  size = ALIGN_SIZE(size);
+  while (mCurrentBlock < mBlocks.size() &&
+         mCurrentOffset + size > mBlockSizes[mCurrentBlock])
+  {
+    // the rest of the block is wasted until the next clear()
+    ++mCurrentBlock;
+    mCurrentOffset = 0;
+  }
+
+  if (mCurrentBlock == mBlocks.size())
+  {
+    const std::size_t block_size = std::max(mBlockSize, size);
+    mBlocks.push_back(new char[block_size]);
+    mBlockSizes.push_back(block_size);
+  }
+
+  void* p_memory = mBlocks[mCurrentBlock] + mCurrentOffset;
+  mCurrentOffset += size;
+  return p_memory;
+}
+
+template <typename T>
+cv::Ptr<T> BlobArena::share(T* pObject, std::vector<Entry<T> >& entries)
+{
+  Entry<T> entry;
+  entry.pObject = pObject;
+  entry.pRefcount = static_cast<int*>(allocate(sizeof(int)));
+  // one reference for the arena, so cv::Ptr never deletes the object, and
+  // one for the returned cv::Ptr
+  *entry.pRefcount = 2;
+  entries.push_back(entry);
+  return adoptPtr(pObject, entry.pRefcount);
+}
+
+template <typename T>
+void BlobArena::recycle(T& storage, std::vector<T>& pool)
+{
+  pool.push_back(T());
+  pool.back().swap(storage);
+  pool.back().clear();
+}
+
+template <typename T>
+void BlobArena::reuse(T& storage, std::vector<T>& pool)
+{
+  if (!pool.empty())
+  {
+    storage.swap(pool.back());
+    pool.pop_back();
+  }
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,159 @@
+/**
+ * @brief Arena the blobs and contours of a frame can be allocated from.
+ */
+#ifndef _CVBLOBS2_BLOBARENA_H_
+#define _CVBLOBS2_BLOBARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <cvblobs2/ChainCodeContainer.h>
+#include <cvblobs2/CvBlobsFwd.h>
+#include <opencv2/core/core.hpp>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class BlobArena
+ * @brief Allocates Blob and BlobContour objects, and their reference counts,
+ * from large memory blocks that are kept from frame to frame.
+ *
+ * Without an arena every blob costs at least four heap allocations: the
+ * Blob, its external BlobContour and the reference count of each cv::Ptr.
+ * Attach an arena to the LabelingWorkspace and the labeling allocates them
+ * all from the arena instead. Once the blocks have grown to the size of a
+ * frame, labeling the next frames doesn't allocate any of these objects.
+ * The storage of the chain codes and of the contour lists of the destroyed
+ * objects is kept too, and handed to the next objects, so once it has grown
+ * labeling a frame hardly allocates at all.
+ * @code
+   cvblobs::BlobArena arena;
+   cvblobs::LabelingWorkspace workspace;
+   workspace.setArena(&arena);
+
+   cvblobs::BlobResult result;
+   result.setArena(&arena);
+   for (;;)
+   {
+     capture >> frame;
+     cvblobs::BlobContainerType blobs;
+     cvblobs::ComponentLabeling(frame, cv::Mat(), 0, blobs, workspace);
+     for (std::size_t i = 0; i < blobs.size(); ++i)
+     {
+       result.addBlob(blobs[i]);
+     }
+     blobs.clear();
+     // ... use result ...
+     result.clearBlobs(); // also clears the arena
+   }
+   @endcode
+ *
+ * The objects handed out are reference counted like any other cv::Ptr, but
+ * the arena holds one extra reference so they are never deleted by cv::Ptr.
+ * They are destroyed together by clear(). Every cv::Ptr to an object of the
+ * arena must have been released when clear() is called. A copy that outlives
+ * clear() points to a destroyed object. Don't copy blobs of the arena into
+ * containers that live longer than the frame.
+ *
+ * An arena isn't thread safe. The labeling only creates blobs from the
+ * calling thread, also when it runs in parallel.
+ */
+class BlobArena
+{
+ public:
+
+  /**
+   * @brief Creates an empty arena
+   * @param blockSize bytes of each memory block
+   */
+  explicit BlobArena(std::size_t blockSize = 64 * 1024);
+
+  /**
+   * @brief Destroys the objects and frees the memory blocks
+   */
+  ~BlobArena();
+
+  /**
+   * @brief Creates a blob and its external contour in the arena, see
+   * Blob::Blob()
+   */
+  cv::Ptr<Blob> createBlob(LabelType id,
+                           const cv::Point& startPoint,
+                           const cv::Size& originalImageSize);
+
+  /**
+   * @brief Creates a contour in the arena, see BlobContour::BlobContour()
+   */
+  cv::Ptr<BlobContour> createContour(const cv::Point& startPoint);
+
+  /**
+   * @brief Destroys every object of the arena. The memory blocks are kept
+   * and reused by the next objects.
+   * @pre no cv::Ptr to an object of the arena is left, checked with
+   * CV_Assert() in release builds too
+   */
+  void clear();
+
+  /**
+   * @brief Frees the memory blocks, after destroying the objects
+   */
+  void release();
+
+  /**
+   * @brief Returns the number of objects in the arena
+   */
+  inline std::size_t numObjects() const;
+
+ private:
+
+  //! An object of the arena and its reference count
+  template <typename T>
+  struct Entry
+  {
+    T* pObject;
+    int* pRefcount;
+  };
+
+  //! Returns \p size bytes, aligned for any of the objects
+  void* allocate(std::size_t size);
+
+  //! Returns a cv::Ptr to \p pObject with a reference count from the arena
+  template <typename T>
+  cv::Ptr<T> share(T* pObject, std::vector<Entry<T> >& entries);
+
+  //! Empties \p storage and moves its memory to \p pool
+  template <typename T>
+  static void recycle(T& storage, std::vector<T>& pool);
+
+  //! Gives the empty \p storage the memory of the last of \p pool, if any
+  template <typename T>
+  static void reuse(T& storage, std::vector<T>& pool);
+
+  //! size of new blocks
+  std::size_t mBlockSize;
+  //! memory blocks, mBlocks[i] holds mBlockSizes[i] bytes
+  std::vector<char*> mBlocks;
+  std::vector<std::size_t> mBlockSizes;
+  //! block being allocated from and bytes of it already used
+  std::size_t mCurrentBlock;
+  std::size_t mCurrentOffset;
+
+  //! objects to destroy on clear(), blobs before the contours they use
+  std::vector<Entry<Blob> > mBlobs;
+  std::vector<Entry<BlobContour> > mContours;
+
+  //! storage of the chain codes and contour lists of the destroyed objects
+  std::vector<ChainCodeContainer> mFreeChainCodes;
+  std::vector<ContourContainerType> mFreeContourLists;
+
+  CVBLOBS_DISALLOW_EVIL_CONSTRUCTORS(BlobArena)
+};
+
+inline std::size_t BlobArena::numObjects() const
+{
+  return mBlobs.size() + mContours.size();
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBARENA_H_
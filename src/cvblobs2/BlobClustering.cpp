@@ -0,0 +1,333 @@
+#include <cvblobs2/BlobClustering.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobContour.h>
+#include <cvblobs2/BlobResult.h>
+#include <cvblobs2/BlobSpatialIndex.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! blob without a cluster yet
+const std::size_t NO_CLUSTER = static_cast<std::size_t>(-1);
+
+//! Returns the root of the set of \p i, halving the path to it
+std::size_t findRoot(std::vector<std::size_t>& parents, std::size_t i)
+{
+  while (parents[i] != i)
+  {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+//! Joins the sets of \p i and \p j, the smaller index being the root
+void uniteRoots(std::vector<std::size_t>& parents,
+                std::size_t i,
+                std::size_t j)
+{
+  i = findRoot(parents, i);
+  j = findRoot(parents, j);
+  if (i < j)
+  {
+    parents[j] = i;
+  }
+  else if (j < i)
+  {
+    parents[i] = j;
+  }
+}
+
+//! Distance between the nearest pixels of two bounding boxes, 0 if they
+//! overlap
+double boxDistance(const cv::Rect& lhs, const cv::Rect& rhs)
+{
+  const int dx = std::max(0, std::max(rhs.x - (lhs.x + lhs.width - 1),
+                                      lhs.x - (rhs.x + rhs.width - 1)));
+  const int dy = std::max(0, std::max(rhs.y - (lhs.y + lhs.height - 1),
+                                      lhs.y - (rhs.y + rhs.height - 1)));
+  return std::sqrt(static_cast<double>(dx) * dx +
+                   static_cast<double>(dy) * dy);
+}
+
+//! Appends the points of \p pContour to \p points
+void appendContourPoints(const cv::Ptr<BlobContour>& pContour,
+                         PointContainerType& points)
+{
+  if (pContour.empty())
+  {
+    return;
+  }
+  cv::Ptr<BlobContour> p_contour = pContour;
+  const PointContainerType& contour_points = p_contour->contourPoints();
+  points.insert(points.end(), contour_points.begin(), contour_points.end());
+}
+
+//! Sets \p points to the points of all of the contours of \p pBlob. The
+//! pixels of a blob nearest to another one are on one of them.
+void blobContourPoints(const cv::Ptr<Blob>& pBlob, PointContainerType& points)
+{
+  cv::Ptr<Blob> p_blob = pBlob;
+  points.clear();
+  appendContourPoints(p_blob->externalContour(), points);
+  for (std::size_t k = 0; k < p_blob->numJoinedContours(); ++k)
+  {
+    appendContourPoints(p_blob->joinedContour(k), points);
+  }
+  for (std::size_t k = 0; k < p_blob->numInternalContours(); ++k)
+  {
+    appendContourPoints(p_blob->internalContour(k), points);
+  }
+}
+
+//! Sets \p nearPoints to the points of \p points inside \p rect
+void pointsInside(const PointContainerType& points,
+                  const cv::Rect& rect,
+                  PointContainerType& nearPoints)
+{
+  nearPoints.clear();
+  for (std::size_t k = 0; k < points.size(); ++k)
+  {
+    if (rect.contains(points[k]))
+    {
+      nearPoints.push_back(points[k]);
+    }
+  }
+}
+
+//! Returns \p value / \p divisor rounded down, \p divisor being positive
+inline int floorDivide(int value, int divisor)
+{
+  return value >= 0 ? value / divisor : -((divisor - 1 - value) / divisor);
+}
+
+//! Orders points by the cell of a grid of square cells they are in, row of
+//! cells after row of cells
+struct CellOrder
+{
+  explicit CellOrder(int cellSize)
+      : mCellSize(cellSize)
+  {}
+
+  //! Returns the column and row of the cell of \p point
+  cv::Point cell(const cv::Point& point) const
+  {
+    return cv::Point(floorDivide(point.x, mCellSize),
+                     floorDivide(point.y, mCellSize));
+  }
+
+  //! Returns the top left point of the cell \p cellPosition
+  cv::Point corner(const cv::Point& cellPosition) const
+  {
+    return cv::Point(cellPosition.x * mCellSize,
+                     cellPosition.y * mCellSize);
+  }
+
+  bool operator()(const cv::Point& lhs, const cv::Point& rhs) const
+  {
+    const cv::Point lhs_cell = cell(lhs);
+    const cv::Point rhs_cell = cell(rhs);
+    return lhs_cell.y < rhs_cell.y ||
+        (lhs_cell.y == rhs_cell.y && lhs_cell.x < rhs_cell.x);
+  }
+
+  //! width and height of the cells, in pixels
+  int mCellSize;
+};
+
+//! Returns true if a point of \p lhs is at most \p gap away from a point of
+//! \p rhs. \p rhs is sorted into a grid of cells as wide as \p gap, so
+//! only its points in the 3x3 cells around a point of \p lhs are compared.
+bool pointsWithin(const PointContainerType& lhs,
+                  PointContainerType& rhs,
+                  double gap)
+{
+  const CellOrder order(std::max(1, static_cast<int>(std::ceil(gap))));
+  std::sort(rhs.begin(), rhs.end(), order);
+  const PointContainerType& sorted_rhs = rhs;
+
+  const double gap_squared = gap * gap;
+  for (std::size_t a = 0; a < lhs.size(); ++a)
+  {
+    const cv::Point cell = order.cell(lhs[a]);
+    for (int row = cell.y - 1; row <= cell.y + 1; ++row)
+    {
+      // the 3 cells of a row are next to each other in rhs
+      PointContainerType::const_iterator first =
+          std::lower_bound(sorted_rhs.begin(),
+                           sorted_rhs.end(),
+                           order.corner(cv::Point(cell.x - 1, row)),
+                           order);
+      PointContainerType::const_iterator last =
+          std::upper_bound(first,
+                           sorted_rhs.end(),
+                           order.corner(cv::Point(cell.x + 1, row)),
+                           order);
+      for (; first != last; ++first)
+      {
+        const double dx = lhs[a].x - first->x;
+        const double dy = lhs[a].y - first->y;
+        if (dx * dx + dy * dy <= gap_squared)
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+//! Returns \p rect grown by \p margin pixels on every side
+cv::Rect expandRect(const cv::Rect& rect, int margin)
+{
+  return cv::Rect(rect.x - margin,
+                  rect.y - margin,
+                  rect.width + 2 * margin,
+                  rect.height + 2 * margin);
+}
+
+} // end anonymous namespace
+
+std::size_t ClusterBlobs(const BlobResult& blobs,
+                         double gap,
+                         std::vector<std::size_t>& clusters,
+                         ClusterDistance distance /*= CLUSTER_BOUNDING_BOX*/)
+{
+  const std::size_t num_blobs = blobs.numBlobs();
+  std::vector<std::size_t> parents(num_blobs);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    parents[i] = i;
+  }
+
+  if (gap >= 0.0 && num_blobs > 1)
+  {
+    // the blobs closer than gap have a bounding box intersecting the box of
+    // the other one grown by gap
+    const BlobSpatialIndex index(blobs);
+    const int margin = static_cast<int>(std::ceil(gap));
+    std::vector<std::size_t> neighbours;
+
+    // contour points of the blobs, gathered the first time they are needed
+    std::vector<PointContainerType> contour_points;
+    std::vector<unsigned char> has_contour_points;
+    PointContainerType near_points_i;
+    PointContainerType near_points_j;
+    if (distance == CLUSTER_CONTOUR)
+    {
+      contour_points.resize(num_blobs);
+      has_contour_points.assign(num_blobs, 0);
+    }
+
+    for (std::size_t i = 0; i < num_blobs; ++i)
+    {
+      const cv::Rect& box_i = index.boundingBox(i);
+      index.intersecting(expandRect(box_i, margin), neighbours);
+      for (std::size_t k = 0; k < neighbours.size(); ++k)
+      {
+        // every pair once, and none already in the same cluster
+        const std::size_t j = neighbours[k];
+        if (j <= i || findRoot(parents, i) == findRoot(parents, j))
+        {
+          continue;
+        }
+        const cv::Rect& box_j = index.boundingBox(j);
+        if (boxDistance(box_i, box_j) > gap)
+        {
+          continue;
+        }
+
+        if (distance == CLUSTER_CONTOUR)
+        {
+          if (!has_contour_points[i])
+          {
+            blobContourPoints(blobs.blob(i), contour_points[i]);
+            has_contour_points[i] = 1;
+          }
+          if (!has_contour_points[j])
+          {
+            blobContourPoints(blobs.blob(j), contour_points[j]);
+            has_contour_points[j] = 1;
+          }
+          // only the points near the other box can be close enough
+          pointsInside(contour_points[i], expandRect(box_j, margin),
+                       near_points_i);
+          pointsInside(contour_points[j], expandRect(box_i, margin),
+                       near_points_j);
+          if (!pointsWithin(near_points_i, near_points_j, gap))
+          {
+            continue;
+          }
+        }
+        uniteRoots(parents, i, j);
+      }
+    }
+  }
+
+  // the root of every cluster is its first blob
+  clusters.assign(num_blobs, NO_CLUSTER);
+  std::size_t num_clusters = 0;
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    const std::size_t root = findRoot(parents, i);
+    if (clusters[root] == NO_CLUSTER)
+    {
+      clusters[root] = num_clusters++;
+    }
+    clusters[i] = clusters[root];
+  }
+  return num_clusters;
+}
+
+void MergeClusters(const BlobResult& blobs,
+                   const std::vector<std::size_t>& clusters,
+                   std::size_t numClusters,
+                   BlobResult& merged)
+{
+  // first blob of every cluster, then the copy the others are joined to
+  // once the cluster has a second blob
+  std::vector<cv::Ptr<Blob> > cluster_blobs(numClusters);
+  std::vector<unsigned char> is_copy(numClusters, 0);
+  for (std::size_t i = 0; i < clusters.size(); ++i)
+  {
+    const std::size_t c = clusters[i];
+    cv::Ptr<Blob>& p_cluster_blob = cluster_blobs[c];
+    if (p_cluster_blob.empty())
+    {
+      p_cluster_blob = blobs.blob(i);
+      continue;
+    }
+    if (!is_copy[c])
+    {
+      p_cluster_blob = new Blob(*p_cluster_blob);
+      is_copy[c] = 1;
+    }
+    p_cluster_blob->joinBlob(*blobs.blob(i));
+  }
+
+  for (std::size_t c = 0; c < numClusters; ++c)
+  {
+    if (!cluster_blobs[c].empty())
+    {
+      merged.addBlob(cluster_blobs[c]);
+    }
+  }
+}
+
+std::size_t MergeNearbyBlobs(const BlobResult& blobs,
+                             double gap,
+                             BlobResult& merged,
+                             ClusterDistance distance /*= CLUSTER_BOUNDING_BOX*/)
+{
+  std::vector<std::size_t> clusters;
+  const std::size_t num_clusters = ClusterBlobs(blobs, gap, clusters, distance);
+  MergeClusters(blobs, clusters, num_clusters, merged);
+  return num_clusters;
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,63 @@
+/**
+ * @brief Functions to group the blobs that are close to each other and to
+ * merge each group into a single blob.
+ */
+#ifndef _CVBLOBS2_BLOBCLUSTERING_H_
+#define _CVBLOBS2_BLOBCLUSTERING_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Groups the blobs of \p blobs that are at most \p gap pixels apart,
+ * directly or through a chain of other blobs.
+ *
+ * Distances are measured between pixel centers, so two blobs with
+ * 8-connected neighbouring pixels are 1 or sqrt(2) apart. The candidate
+ * pairs are found with a BlobSpatialIndex and joined with a union-find, so
+ * the blobs aren't compared two by two.
+ * @param blobs the blobs to group
+ * @param gap largest distance between two blobs of a cluster
+ * @param clusters set to the cluster of every blob, the clusters are
+ * numbered from 0 in the order of their first blob
+ * @param distance how the distance between two blobs is measured
+ * @return the number of clusters
+ */
+std::size_t ClusterBlobs(const BlobResult& blobs,
+                         double gap,
+                         std::vector<std::size_t>& clusters,
+                         ClusterDistance distance = CLUSTER_BOUNDING_BOX);
+
+/**
+ * @brief Adds to \p merged one blob per cluster of \p clusters, in cluster
+ * order, like BlobResult::filter() adds to its destination. A cluster of one
+ * blob keeps that blob. The blobs of a larger
+ * cluster are joined (see Blob::joinBlob()) into a new blob with the id of
+ * its first blob, whose area, moments and bounding box are the sums and
+ * union of the ones of its blobs.
+ * @param blobs the clustered blobs
+ * @param clusters the cluster of every blob, from ClusterBlobs()
+ * @param numClusters the number of clusters, from ClusterBlobs()
+ * @param merged result the merged blobs are added to, not \p blobs
+ */
+void MergeClusters(const BlobResult& blobs,
+                   const std::vector<std::size_t>& clusters,
+                   std::size_t numClusters,
+                   BlobResult& merged);
+
+/**
+ * @brief ClusterBlobs() then MergeClusters()
+ * @return the number of clusters, the number of blobs added to \p merged
+ */
+std::size_t MergeNearbyBlobs(const BlobResult& blobs,
+                             double gap,
+                             BlobResult& merged,
+                             ClusterDistance distance = CLUSTER_BOUNDING_BOX);
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBCLUSTERING_H_
@@ -8,10 +8,53 @@
 #include <cvblobs2/ChainCode.h>
 #include <cvblobs2/SpatialMoments.h>
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <limits>
 
 CVBLOBS_BEGIN_NAMESPACE
 
+namespace {
+
+//! number of sums accumulated by ADD_EDGE
+const int NUM_EDGE_SUMS = 10;
+
+/**
+ * @brief Adds the terms of the polygon edge \p from -> \p to to the Green's
+ * theorem sums of the area and of the moments, in the order
+ * m00 m10 m01 m20 m11 m02 m30 m21 m12 m03. Same terms as cv::moments().
+ */
+inline void ADD_EDGE(const cv::Point& from, const cv::Point& to, double* pSums)
+{
+  const double x0 = from.x;
+  const double y0 = from.y;
+  const double x1 = to.x;
+  const double y1 = to.y;
+  const double x0_2 = x0 * x0;
+  const double y0_2 = y0 * y0;
+  const double x1_2 = x1 * x1;
+  const double y1_2 = y1 * y1;
+  const double cross = x0 * y1 - x1 * y0;
+  const double sum_x = x0 + x1;
+  const double sum_y = y0 + y1;
+
+  pSums[0] += cross;
+  pSums[1] += cross * sum_x;
+  pSums[2] += cross * sum_y;
+  pSums[3] += cross * (x0 * sum_x + x1_2);
+  pSums[4] += cross * (x0 * (sum_y + y0) + x1 * (sum_y + y1));
+  pSums[5] += cross * (y0 * sum_y + y1_2);
+  pSums[6] += cross * sum_x * (x0_2 + x1_2);
+  pSums[7] += cross * (x0_2 * (3 * y0 + y1) + 2 * x1 * x0 * sum_y +
+                       x1_2 * (y0 + 3 * y1));
+  pSums[8] += cross * (y0_2 * (3 * x0 + x1) + 2 * y1 * y0 * sum_x +
+                       y1_2 * (x0 + 3 * x1));
+  pSums[9] += cross * sum_y * (y0_2 + y1_2);
+}
+
+} // end anonymous namespace
+
 BlobContour::BlobContour()
     : mContour(),
       mStartPoint(std::numeric_limits<cv::Point::value_type>::min(),
@@ -20,6 +63,7 @@ BlobContour::BlobContour()
       mArea(std::numeric_limits<cv::Point::value_type>::min()),
       mPerimeter(std::numeric_limits<cv::Point::value_type>::min()),
       mMoments(),
+      mbPropertiesComputed(false),
       mBoundingBox(std::numeric_limits<cv::Point::value_type>::min(),
                    std::numeric_limits<cv::Point::value_type>::min(),
                    std::numeric_limits<cv::Point::value_type>::min(),
@@ -35,6 +79,7 @@ BlobContour::BlobContour(const cv::Point& startPoint)
       mArea(std::numeric_limits<cv::Point::value_type>::min()),
       mPerimeter(std::numeric_limits<cv::Point::value_type>::min()),
       mMoments(),
+      mbPropertiesComputed(false),
       mBoundingBox(std::numeric_limits<cv::Point::value_type>::min(),
                    std::numeric_limits<cv::Point::value_type>::min(),
                    std::numeric_limits<cv::Point::value_type>::min(),
@@ -45,6 +90,7 @@ BlobContour::BlobContour(const cv::Point& startPoint)
 
 //! Copy constructor
 BlobContour::BlobContour(BlobContour* pSource)
+    : mbPropertiesComputed(false)
 {
 	if (pSource != NULL)
 	{
@@ -59,6 +105,7 @@ BlobContour::BlobContour(const BlobContour& source)
       mArea(source.mArea),
       mPerimeter(source.mPerimeter),
       mMoments(source.mMoments),
+      mbPropertiesComputed(source.mbPropertiesComputed),
       mBoundingBox(source.mBoundingBox)
 {}
 
@@ -82,12 +129,13 @@ BlobContour& BlobContour::operator=(const BlobContour& source)
 //! swaps contents of this contour with other
 void BlobContour::swap(BlobContour& other)
 {
-  std::swap(mContour, other.mContour);
+  mContour.swap(other.mContour);
   std::swap(mStartPoint, other.mStartPoint);
   std::swap(mContourPoints, other.mContourPoints);
   std::swap(mArea, other.mArea);
   std::swap(mPerimeter, other.mPerimeter);
   std::swap(mMoments, other.mMoments);
+  std::swap(mbPropertiesComputed, other.mbPropertiesComputed);
   std::swap(mBoundingBox, other.mBoundingBox);
 }
 
@@ -107,6 +155,7 @@ void BlobContour::swap(BlobContour& other)
 void BlobContour::addChainCode(ChainCodeType chaincode)
 {
   mContour.push_back(chaincode);
+  mbPropertiesComputed = false;
   mBoundingBox = cv::Rect(std::numeric_limits<cv::Point::value_type>::min(),
                           std::numeric_limits<cv::Point::value_type>::min(),
                           std::numeric_limits<cv::Point::value_type>::min(),
@@ -122,6 +171,7 @@ void BlobContour::clear()
   mPerimeter = std::numeric_limits<cv::Point::value_type>::min();
   mMoments = cv::Moments();
   mMoments.m00 = std::numeric_limits<cv::Point::value_type>::min();
+  mbPropertiesComputed = false;
   mBoundingBox = cv::Rect(std::numeric_limits<cv::Point::value_type>::min(),
                           std::numeric_limits<cv::Point::value_type>::min(),
                           std::numeric_limits<cv::Point::value_type>::min(),
@@ -144,18 +194,16 @@ void BlobContour::clear()
 */
 double BlobContour::perimeter()
 {
-	// is calculated?
-	if (mPerimeter != std::numeric_limits<cv::Point::value_type>::min())
-	{
-		return mPerimeter;
-	}
-
 	if (isEmpty())
   {
 		return 0;
   }
 
-  mPerimeter = cv::arcLength(contourPoints(), 1 );
+	// is calculated?
+	if (!mbPropertiesComputed)
+	{
+    computeProperties();
+	}
 	return mPerimeter;
 }
 
@@ -175,18 +223,16 @@ double BlobContour::perimeter()
 */
 double BlobContour::area()
 {
-	// is calculated?
-	if (mArea != std::numeric_limits<cv::Point::value_type>::min())
-	{
-		return mArea;
-	}
-
 	if (isEmpty())
   {
 		return 0;
   }
 
-	mArea = fabs( cv::contourArea(contourPoints()) );
+	// is calculated?
+	if (!mbPropertiesComputed)
+	{
+    computeProperties();
+	}
 	return mArea;
 }
 
@@ -199,14 +245,84 @@ double BlobContour::moment(int p, int q)
   }
   
 	// it is calculated?
-	if (mMoments.m00 == std::numeric_limits<cv::Point::value_type>::min())
+	if (!mbPropertiesComputed)
 	{
-    mMoments = cv::moments(contourPoints(), true);
+    computeProperties();
 	}
 		
 	return spatialMoment(mMoments, p, q);
 }
 
+void BlobContour::computeProperties()
+{
+  double sums[NUM_EDGE_SUMS] = {0};
+  int num_straight = 0;
+  int num_diagonal = 0;
+  cv::Point min_point = mStartPoint;
+  cv::Point max_point = mStartPoint;
+
+  // walk the contour pixels, each code is a polygon edge
+  cv::Point point = mStartPoint;
+  ChainCodeContainerType::const_iterator end_iter = mContour.end();
+	for (ChainCodeContainerType::const_iterator iter = mContour.begin();
+       iter != end_iter;
+       ++iter)
+	{
+    const ChainCode chain_code = *iter;
+    const cv::Point next_point = movePoint(point, chain_code);
+    ADD_EDGE(point, next_point, sums);
+
+    // odd codes are diagonal moves
+    if (chain_code & 1)
+    {
+      ++num_diagonal;
+    }
+    else
+    {
+      ++num_straight;
+    }
+
+    min_point.x = std::min(min_point.x, next_point.x);
+    min_point.y = std::min(min_point.y, next_point.y);
+    max_point.x = std::max(max_point.x, next_point.x);
+    max_point.y = std::max(max_point.y, next_point.y);
+    point = next_point;
+	}
+
+  // close the polygon if the codes don't end on the start point
+  ADD_EDGE(point, mStartPoint, sums);
+  const cv::Point closing = mStartPoint - point;
+
+  mPerimeter = num_straight + num_diagonal * std::sqrt(2.0) +
+      std::sqrt(static_cast<double>(closing.x * closing.x +
+                                    closing.y * closing.y));
+  mArea = std::fabs(sums[0]) / 2.0;
+
+  // moments of a degenerated polygon are all 0
+  mMoments = cv::Moments();
+  if (std::fabs(sums[0]) > FLT_EPSILON)
+  {
+    // the sign of the sums depends on the orientation of the contour
+    const double sign = sums[0] > 0 ? 1.0 : -1.0;
+    mMoments = cv::Moments(sign * sums[0] / 2.0,
+                           sign * sums[1] / 6.0,
+                           sign * sums[2] / 6.0,
+                           sign * sums[3] / 12.0,
+                           sign * sums[4] / 24.0,
+                           sign * sums[5] / 12.0,
+                           sign * sums[6] / 20.0,
+                           sign * sums[7] / 60.0,
+                           sign * sums[8] / 60.0,
+                           sign * sums[9] / 20.0);
+  }
+
+  mBoundingBox = cv::Rect(min_point.x,
+                          min_point.y,
+                          max_point.x - min_point.x + 1,
+                          max_point.y - min_point.y + 1);
+  mbPropertiesComputed = true;
+}
+
 //! Calculate contour points from crack codes
 const PointContainerType& BlobContour::contourPoints()
 {
@@ -281,8 +397,14 @@ const PointContainerType& BlobContour::contourPoints()
 
 cv::Rect BlobContour::boundingBox()
 {
+  // a blob of a single pixel has no chain codes, only its start point
   if (isEmpty())
   {
+    if (mStartPoint.x != std::numeric_limits<cv::Point::value_type>::min() &&
+        mStartPoint.y != std::numeric_limits<cv::Point::value_type>::min())
+    {
+      return cv::Rect(mStartPoint, cv::Size(1, 1));
+    }
     return cv::Rect();
   }
   
@@ -294,7 +416,7 @@ cv::Rect BlobContour::boundingBox()
   }
 
   // computes bounding box
-  contourPoints();
+  computeProperties();
   return mBoundingBox;
 }
 
@@ -2,6 +2,7 @@
 #define _CVBLOBS2_BLOBCONTOUR_H_
 
 #include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/ChainCodeContainer.h>
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
@@ -17,6 +18,7 @@ CVBLOBS_BEGIN_NAMESPACE
 class BlobContour
 {
 	friend class Blob;
+  friend class BlobArena;
 	
  public:
 
@@ -99,6 +101,8 @@ class BlobContour
   
   /** 
    * @brief Computes the area of the contour
+   * The area, the perimeter, the moments and the bounding box are computed
+   * together in one pass over the chain codes and cached.
    */
 	double area();
   
@@ -131,10 +135,19 @@ class BlobContour
   
  protected:	
 
-	//! Crack code list
+	//! Crack codes, packed
 	ChainCodeContainerType mContour;
 
  private:
+
+  /**
+   * @brief Computes the area, perimeter, moments and bounding box from the
+   * chain codes, without building contourPoints(). The polygon through the
+   * contour pixels is integrated edge by edge with Green's theorem, which
+   * gives the same values as cv::contourArea(), cv::arcLength() and
+   * cv::moments() on contourPoints().
+   */
+  void computeProperties();
   
 	//! Starting point of the contour
   cv::Point mStartPoint;
@@ -147,6 +160,8 @@ class BlobContour
 	double mPerimeter;
 	//! Computed moments from contour
   cv::Moments mMoments;
+  //! mArea, mPerimeter and mMoments are up to date
+  bool mbPropertiesComputed;
 
   //! bounding box
   cv::Rect mBoundingBox;
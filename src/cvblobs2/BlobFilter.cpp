@@ -0,0 +1,135 @@
+#include <cvblobs2/BlobFilter.h>
+
+#include <algorithm>
+
+#include <cvblobs2/BlobOperators.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+/**
+ * @brief Orders nodes by increasing cost
+ */
+template <typename NodePtr>
+struct CheaperNode
+{
+  bool operator()(const NodePtr& pLhs, const NodePtr& pRhs) const
+  {
+    return pLhs->cost < pRhs->cost;
+  }
+};
+
+} // end anonymous namespace
+
+BlobFilter::BlobFilter(const cv::Ptr<BlobOperator>& pOperator,
+                       FilterCondition condition,
+                       double lowLimit,
+                       double highLimit /*= 0*/)
+    : mpNode(new Node())
+{
+  mpNode->type = NODE_CONDITION;
+  mpNode->pOperator = pOperator;
+  mpNode->condition = condition;
+  mpNode->lowLimit = lowLimit;
+  mpNode->highLimit = highLimit;
+  mpNode->cost = pOperator->cost();
+}
+
+BlobFilter::BlobFilter(const cv::Ptr<Node>& pNode)
+    : mpNode(pNode)
+{}
+
+BlobFilter BlobFilter::operator&(const BlobFilter& other) const
+{
+  return combine(NODE_AND, *this, other);
+}
+
+BlobFilter BlobFilter::operator|(const BlobFilter& other) const
+{
+  return combine(NODE_OR, *this, other);
+}
+
+BlobFilter BlobFilter::operator!() const
+{
+  cv::Ptr<Node> p_node = new Node();
+  p_node->type = NODE_NOT;
+  p_node->condition = CONDITION_EQUAL;
+  p_node->lowLimit = 0.0;
+  p_node->highLimit = 0.0;
+  p_node->children.push_back(mpNode);
+  p_node->cost = mpNode->cost;
+  return BlobFilter(p_node);
+}
+
+BlobFilter BlobFilter::combine(NodeType type,
+                               const BlobFilter& lhs,
+                               const BlobFilter& rhs)
+{
+  cv::Ptr<Node> p_node = new Node();
+  p_node->type = type;
+  p_node->condition = CONDITION_EQUAL;
+  p_node->lowLimit = 0.0;
+  p_node->highLimit = 0.0;
+  p_node->cost = lhs.cost() + rhs.cost();
+
+  // (a & b) & c is a & b & c, so all three are sorted together
+  const cv::Ptr<Node> operands[2] = { lhs.mpNode, rhs.mpNode };
+  for (int i = 0; i < 2; ++i)
+  {
+    const Node& operand = *operands[i];
+    if (operand.type == type)
+    {
+      p_node->children.insert(p_node->children.end(),
+                              operand.children.begin(),
+                              operand.children.end());
+    }
+    else
+    {
+      p_node->children.push_back(operands[i]);
+    }
+  }
+  // stable to keep the order of the terms of equal cost
+  std::stable_sort(p_node->children.begin(),
+                   p_node->children.end(),
+                   CheaperNode<cv::Ptr<Node> >());
+  return BlobFilter(p_node);
+}
+
+bool BlobFilter::evaluate(const Node& node, const cv::Ptr<Blob>& pBlob)
+{
+  switch (node.type)
+  {
+    case NODE_CONDITION:
+    {
+      cv::Ptr<BlobOperator> p_operator = node.pOperator;
+      return passesCondition(p_operator->result(pBlob),
+                             node.condition,
+                             node.lowLimit,
+                             node.highLimit);
+    }
+    case NODE_AND:
+      for (std::size_t i = 0; i < node.children.size(); ++i)
+      {
+        if (!evaluate(*node.children[i], pBlob))
+        {
+          return false;
+        }
+      }
+      return true;
+    case NODE_OR:
+      for (std::size_t i = 0; i < node.children.size(); ++i)
+      {
+        if (evaluate(*node.children[i], pBlob))
+        {
+          return true;
+        }
+      }
+      return false;
+    case NODE_NOT:
+      return !evaluate(*node.children.front(), pBlob);
+  }
+  return false;
+}
+
+CVBLOBS_END_NAMESPACE
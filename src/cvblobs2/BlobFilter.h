@@ -0,0 +1,171 @@
+/**
+ * @brief Conditions on blob properties combined with AND, OR and NOT.
+ */
+#ifndef _CVBLOBS2_BLOBFILTER_H_
+#define _CVBLOBS2_BLOBFILTER_H_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Returns true if \p value meets \p condition with the limits
+ * \p lowLimit and \p highLimit, the latter only used by CONDITION_INSIDE and
+ * CONDITION_OUTSIDE
+ */
+inline bool passesCondition(double value,
+                            FilterCondition condition,
+                            double lowLimit,
+                            double highLimit);
+
+/**
+ * @class BlobFilter
+ * @brief Predicate on a Blob made of conditions on the results of
+ * BlobOperators, combined with &, | and !.
+ *
+ * For example, to keep the blobs with an area in [50, 5000] and a
+ * compactness under 2 that don't touch the border of the image:
+ * @code
+ * BlobFilter filter =
+ *     BlobFilter(new BlobGetArea(), CONDITION_INSIDE, 50, 5000) &
+ *     BlobFilter(new BlobGetCompactness(), CONDITION_LESS, 2) &
+ *     !BlobFilter(new BlobGetExterior(mask), CONDITION_NOT_EQUAL, 0);
+ * blobs.filter(blobs, ACTION_INCLUDE, filter);
+ * @endcode
+ *
+ * The filter is evaluated on one blob at a time and stops as soon as the
+ * result is known. The terms of an AND or an OR are evaluated in increasing
+ * order of BlobOperator::cost(), so expensive operations like
+ * BlobGetHullArea or BlobGetMean only run on the blobs that passed the cheap
+ * conditions. The results are cached in the properties of the blobs like
+ * with BlobOperator::result().
+ *
+ * A filter shares its operators with its copies and with the filters it is
+ * combined into, it deletes them with the last of them.
+ */
+class BlobFilter
+{
+ public:
+
+  /**
+   * @brief Filter keeping the blobs whose \p pOperator result meets
+   * \p condition with \p lowLimit and \p highLimit, see
+   * BlobResult::filter(). The filter takes ownership of \p pOperator.
+   */
+  BlobFilter(const cv::Ptr<BlobOperator>& pOperator,
+             FilterCondition condition,
+             double lowLimit,
+             double highLimit = 0);
+
+  /**
+   * @brief Filter keeping the blobs this filter and \p other both keep
+   */
+  BlobFilter operator&(const BlobFilter& other) const;
+
+  /**
+   * @brief Filter keeping the blobs this filter or \p other keeps
+   */
+  BlobFilter operator|(const BlobFilter& other) const;
+
+  /**
+   * @brief Filter keeping the blobs this filter discards
+   */
+  BlobFilter operator!() const;
+
+  /**
+   * @brief Returns true if \p pBlob passes the filter
+   */
+  inline bool operator()(const cv::Ptr<Blob>& pBlob) const;
+
+  /**
+   * @brief Returns the cost of evaluating every condition of the filter, the
+   * sum of the BlobOperator::cost() of their operators
+   */
+  inline double cost() const;
+
+ private:
+
+  //! kind of a node of the expression
+  enum NodeType
+  {
+    NODE_CONDITION,
+    NODE_AND,
+    NODE_OR,
+    NODE_NOT
+  };
+
+  //! node of the expression, never modified once built
+  struct Node
+  {
+    NodeType type;
+    //! operator, condition and limits of a NODE_CONDITION
+    cv::Ptr<BlobOperator> pOperator;
+    FilterCondition condition;
+    double lowLimit;
+    double highLimit;
+    //! terms of a NODE_AND or a NODE_OR in increasing order of cost, the
+    //! negated node of a NODE_NOT
+    std::vector<cv::Ptr<Node> > children;
+    //! sum of the costs of the conditions below the node
+    double cost;
+  };
+
+  explicit BlobFilter(const cv::Ptr<Node>& pNode);
+
+  //! Returns the \p type node of the terms of \p lhs and \p rhs, the terms of
+  //! a node of the same type are merged in
+  static BlobFilter combine(NodeType type,
+                            const BlobFilter& lhs,
+                            const BlobFilter& rhs);
+
+  //! Returns true if \p pBlob passes \p node
+  static bool evaluate(const Node& node, const cv::Ptr<Blob>& pBlob);
+
+  //! root of the expression
+  cv::Ptr<Node> mpNode;
+};
+
+inline bool passesCondition(double value,
+                            FilterCondition condition,
+                            double lowLimit,
+                            double highLimit)
+{
+  switch (condition)
+  {
+    case CONDITION_EQUAL:
+      return value == lowLimit;
+    case CONDITION_NOT_EQUAL:
+      return value != lowLimit;
+    case CONDITION_GREATER:
+      return value > lowLimit;
+    case CONDITION_LESS:
+      return value < lowLimit;
+    case CONDITION_GREATER_OR_EQUAL:
+      return value >= lowLimit;
+    case CONDITION_LESS_OR_EQUAL:
+      return value <= lowLimit;
+    case CONDITION_INSIDE:
+      return (value >= lowLimit) && (value <= highLimit);
+    case CONDITION_OUTSIDE:
+      return (value < lowLimit) || (value > highLimit);
+  }
+  return false;
+}
+
+inline bool BlobFilter::operator()(const cv::Ptr<Blob>& pBlob) const
+{
+  return evaluate(*mpNode, pBlob);
+}
+
+inline double BlobFilter::cost() const
+{
+  return mpNode->cost;
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBFILTER_H_
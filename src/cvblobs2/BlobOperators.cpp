@@ -7,6 +7,7 @@
 
 // std
 #include <limits>
+#include <sstream>
 
 // opencv
 #include <opencv2/imgproc/imgproc.hpp>
@@ -14,9 +15,101 @@
 // cvblobs
 #include <cvblobs2/Blob.h>
 #include <cvblobs2/BlobContour.h>
+#include <cvblobs2/ConvexHull.h>
 
 CVBLOBS_BEGIN_NAMESPACE
 
+namespace {
+
+//! cost of the built-in operations, indexed by PropertyId
+const double PROPERTY_COSTS[] =
+{
+  COST_BOUNDS,          // PROPERTY_ID
+  COST_MOMENTS,         // PROPERTY_AREA
+  COST_MOMENTS,         // PROPERTY_PERIMETER
+  COST_MOMENTS,         // PROPERTY_COMPACTNESS
+  COST_MOMENTS,         // PROPERTY_LENGTH
+  COST_MOMENTS,         // PROPERTY_BREADTH
+  COST_BOUNDS,          // PROPERTY_DIFF_X
+  COST_BOUNDS,          // PROPERTY_DIFF_Y
+  COST_HULL,            // PROPERTY_HULL_PERIMETER
+  COST_HULL,            // PROPERTY_HULL_AREA
+  COST_CONTOUR_POINTS,  // PROPERTY_MIN_X_AT_MIN_Y
+  COST_CONTOUR_POINTS,  // PROPERTY_MIN_Y_AT_MAX_X
+  COST_CONTOUR_POINTS,  // PROPERTY_MAX_X_AT_MAX_Y
+  COST_CONTOUR_POINTS,  // PROPERTY_MAX_Y_AT_MIN_X
+  COST_BOUNDS,          // PROPERTY_MIN_X
+  COST_BOUNDS,          // PROPERTY_MAX_X
+  COST_BOUNDS,          // PROPERTY_MIN_Y
+  COST_BOUNDS,          // PROPERTY_MAX_Y
+  COST_MOMENTS,         // PROPERTY_ELONGATION
+  COST_HULL,            // PROPERTY_ROUGHNESS
+  COST_BOUNDS,          // PROPERTY_X_CENTER
+  COST_BOUNDS,          // PROPERTY_Y_CENTER
+  COST_MOMENTS,         // PROPERTY_MAJOR_AXIS_LENGTH
+  COST_MOMENTS,         // PROPERTY_AREA_ELIPSE_RATIO
+  COST_MOMENTS,         // PROPERTY_MINOR_AXIS_LENGTH
+  COST_MOMENTS,         // PROPERTY_ORIENTATION
+  COST_MOMENTS,         // PROPERTY_ELIPSE_X_CENTER
+  COST_MOMENTS,         // PROPERTY_ELIPSE_Y_CENTER
+  COST_MOMENTS,         // PROPERTY_ORIENTATION_COS
+  COST_MOMENTS,         // PROPERTY_AXIS_RATIO
+  COST_HULL,            // PROPERTY_MAX_FERET_DIAMETER
+  COST_HULL,            // PROPERTY_MAX_FERET_ANGLE
+  COST_HULL,            // PROPERTY_MIN_FERET_DIAMETER
+  COST_HULL,            // PROPERTY_MIN_FERET_ANGLE
+  COST_HULL,            // PROPERTY_MIN_RECT_LENGTH
+  COST_HULL,            // PROPERTY_MIN_RECT_BREADTH
+  COST_HULL,            // PROPERTY_MIN_RECT_ANGLE
+  COST_HULL             // PROPERTY_MIN_RECT_AREA
+};
+CVBLOBS_STATIC_ASSERT(sizeof(PROPERTY_COSTS) / sizeof(PROPERTY_COSTS[0]) ==
+                      PROPERTY_COUNT,
+                      PROPERTY_COSTS_must_have_a_cost_per_PropertyId);
+
+//! Caches the Feret diameter \p diameter, the maximum one if \p bMax, and
+//! its angle, which are computed together
+void setFeretProperties(cv::Ptr<Blob> pBlob,
+                        bool bMax,
+                        double diameter,
+                        double angle)
+{
+  Blob::PropertiesType* p_properties = pBlob->properties();
+  p_properties->set(bMax ? PROPERTY_MAX_FERET_DIAMETER :
+                           PROPERTY_MIN_FERET_DIAMETER, diameter);
+  p_properties->set(bMax ? PROPERTY_MAX_FERET_ANGLE :
+                           PROPERTY_MIN_FERET_ANGLE, angle);
+}
+
+//! Computes the minimum area rectangle of \p pBlob and caches its four
+//! properties
+cv::RotatedRect minAreaRect(cv::Ptr<Blob> pBlob)
+{
+  const cv::RotatedRect rect = hullMinAreaRect(pBlob->convexHull());
+  Blob::PropertiesType* p_properties = pBlob->properties();
+  p_properties->set(PROPERTY_MIN_RECT_LENGTH, rect.size.width);
+  p_properties->set(PROPERTY_MIN_RECT_BREADTH, rect.size.height);
+  p_properties->set(PROPERTY_MIN_RECT_ANGLE, rect.angle);
+  p_properties->set(PROPERTY_MIN_RECT_AREA,
+                    static_cast<double>(rect.size.width) * rect.size.height);
+  return rect;
+}
+
+//! Starts the key() of the operation \p name, followed by its parameters
+void beginKey(std::ostringstream& key, const std::string& name)
+{
+  key.precision(17);
+  key << name << '(';
+}
+
+//! Identifies an image parameter of an operation by the address of its pixels
+inline const void* imageKey(const cv::Mat& image)
+{
+  return image.data;
+}
+
+} // end anonymous namespace
+
 //////////////////
 // BlobOperator //
 //////////////////
@@ -27,24 +120,49 @@ double BlobOperator::result(cv::Ptr<Blob> pBlob)
 {
   double result;
 
-  // verify if operator is calculated
+  // verify if operator is calculated, if not calculate it and add it to
+  // blob properties
   Blob::PropertiesType* p_props = pBlob->properties();
-  Blob::PropertiesType::iterator iter = p_props->find(name());
-  if (iter == p_props->end())
+  const PropertyId id = propertyId();
+  if (id != PROPERTY_NAMED)
   {
-    // if not calculate it and add it to blob properties
-    result = operator()(pBlob);
-    (*p_props)[name()] = result;
+    if (!p_props->find(id, result))
+    {
+      result = operator()(pBlob);
+      p_props->set(id, result);
+    }
+    return result;
   }
-  else
+
+  const std::string key = this->key();
+  if (!p_props->find(key, result))
   {
-    // if is calculate, get result (without calculating it again)
-    result = iter->second;
+    result = operator()(pBlob);
+    p_props->set(key, result);
   }
-
   return result;
 }
 
+std::string BlobOperator::key()
+{
+  return name();
+}
+
+PropertyId BlobOperator::propertyId() const
+{
+  return PROPERTY_NAMED;
+}
+
+double BlobOperator::cost() const
+{
+  const PropertyId id = propertyId();
+  if (id == PROPERTY_NAMED)
+  {
+    return COST_PIXELS;
+  }
+  return PROPERTY_COSTS[id];
+}
+
 BlobOperator::operator BlobOperator*()
 {
   return (BlobOperator*)this;
@@ -119,6 +237,19 @@ double BlobGetExterior::operator()(cv::Ptr<Blob> pBlob)
                          mbYBorderTop,  mbYBorderBottom); 
 }
 
+std::string BlobGetExterior::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mMask)
+      << ',' << mbXBorderLeft
+      << ',' << mbXBorderRight
+      << ',' << mbYBorderTop
+      << ',' << mbYBorderBottom
+      << ')';
+  return key.str();
+}
+
 /////////////////
 // BlobGetMean //
 /////////////////
@@ -135,6 +266,14 @@ double BlobGetMean::operator()(cv::Ptr<Blob> pBlob)
   return pBlob->mean(mImage); 
 }
 
+std::string BlobGetMean::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mImage) << ')';
+  return key.str();
+}
+
 ///////////////////
 // BlobGetStdDev //
 ///////////////////
@@ -151,6 +290,14 @@ double BlobGetStdDev::operator()(cv::Ptr<Blob> pBlob)
   return pBlob->stdDev(mImage);
 }
 
+std::string BlobGetStdDev::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mImage) << ')';
+  return key.str();
+}
+
 //////////////////////////
 // BlobGetReferenceMean //
 //////////////////////////
@@ -175,6 +322,14 @@ std::string BlobGetReferencedMean::name()
   return "BlobGetReferencedMean";
 }
 
+std::string BlobGetReferencedMean::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mImage) << ',' << mReference << ')';
+  return key.str();
+}
+
 ////////////////////////
 // BlobGetCompactness //
 ////////////////////////
@@ -297,13 +452,21 @@ double BlobGetMoment::operator()(cv::Ptr<Blob> pBlob)
 	return pBlob->moment(mP, mQ);
 }
 
+std::string BlobGetMoment::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << mP << ',' << mQ << ')';
+  return key.str();
+}
+
 //////////////////////////
 // BlobGetHullPerimeter //
 //////////////////////////
 double BlobGetHullPerimeter::operator()(cv::Ptr<Blob> pBlob)
 {
-	PointContainerType convex_hull;
-  pBlob->convexHull(convex_hull);
+  // the hull is kept by the blob for the other hull based operators
+	const PointContainerType& convex_hull = pBlob->convexHull();
   double perimeter = 0.0;
 
   if (!convex_hull.empty())
@@ -319,8 +482,7 @@ double BlobGetHullPerimeter::operator()(cv::Ptr<Blob> pBlob)
 /////////////////////
 double BlobGetHullArea::operator()(cv::Ptr<Blob> pBlob)
 {
-	PointContainerType convex_hull;
-  pBlob->convexHull(convex_hull);
+	const PointContainerType& convex_hull = pBlob->convexHull();
 	double area = 0.0;
 
   if (!convex_hull.empty())
@@ -572,6 +734,14 @@ double BlobGetDistanceFromPoint::operator()(cv::Ptr<Blob> pBlob)
 	return sqrt( (x_average * x_average) + (y_average * y_average) );
 }
 
+std::string BlobGetDistanceFromPoint::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << mPoint.x << ',' << mPoint.y << ')';
+  return key.str();
+}
+
 ////////////////////////////
 // BlobGetExternPerimeter //
 ////////////////////////////
@@ -602,6 +772,19 @@ double BlobGetExternPerimeter::operator()(cv::Ptr<Blob> pBlob)
                                 mbYBorderTop,  mbYBorderBottom);
 }
 
+std::string BlobGetExternPerimeter::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mMask)
+      << ',' << mbXBorderLeft
+      << ',' << mbXBorderRight
+      << ',' << mbYBorderTop
+      << ',' << mbYBorderBottom
+      << ')';
+  return key.str();
+}
+
 /////////////////////////////////
 // BlobGetExternPerimeterRatio //
 /////////////////////////////////
@@ -642,6 +825,19 @@ double BlobGetExternPerimeterRatio::operator()(cv::Ptr<Blob> pBlob)
   }
 }
 
+std::string BlobGetExternPerimeterRatio::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mMask)
+      << ',' << mbXBorderLeft
+      << ',' << mbXBorderRight
+      << ',' << mbYBorderTop
+      << ',' << mbYBorderBottom
+      << ')';
+  return key.str();
+}
+
 /////////////////////////////////////
 // BlobGetExternHullPerimeterRatio //
 /////////////////////////////////////
@@ -676,6 +872,14 @@ double BlobGetExternHullPerimeterRatio::operator()(cv::Ptr<Blob> pBlob)
   }
 }
 
+std::string BlobGetExternHullPerimeterRatio::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << imageKey(mMask) << ',' << mbXBorder << ',' << mbYBorder << ')';
+  return key.str();
+}
+
 ////////////////////
 // BlobGetXCenter //
 ////////////////////
@@ -793,6 +997,83 @@ double BlobGetAxisRatio::operator()(cv::Ptr<Blob> pBlob)
   }
 }
 
+/////////////////////////////
+// BlobGetMaxFeretDiameter //
+/////////////////////////////
+double BlobGetMaxFeretDiameter::operator()(cv::Ptr<Blob> pBlob)
+{
+  double angle = 0.0;
+  const double diameter = hullMaxFeretDiameter(pBlob->convexHull(), angle);
+  setFeretProperties(pBlob, true, diameter, angle);
+  return diameter;
+}
+
+//////////////////////////
+// BlobGetMaxFeretAngle //
+//////////////////////////
+double BlobGetMaxFeretAngle::operator()(cv::Ptr<Blob> pBlob)
+{
+  double angle = 0.0;
+  const double diameter = hullMaxFeretDiameter(pBlob->convexHull(), angle);
+  setFeretProperties(pBlob, true, diameter, angle);
+  return angle;
+}
+
+/////////////////////////////
+// BlobGetMinFeretDiameter //
+/////////////////////////////
+double BlobGetMinFeretDiameter::operator()(cv::Ptr<Blob> pBlob)
+{
+  double angle = 0.0;
+  const double diameter = hullMinFeretDiameter(pBlob->convexHull(), angle);
+  setFeretProperties(pBlob, false, diameter, angle);
+  return diameter;
+}
+
+//////////////////////////
+// BlobGetMinFeretAngle //
+//////////////////////////
+double BlobGetMinFeretAngle::operator()(cv::Ptr<Blob> pBlob)
+{
+  double angle = 0.0;
+  const double diameter = hullMinFeretDiameter(pBlob->convexHull(), angle);
+  setFeretProperties(pBlob, false, diameter, angle);
+  return angle;
+}
+
+//////////////////////////
+// BlobGetMinRectLength //
+//////////////////////////
+double BlobGetMinRectLength::operator()(cv::Ptr<Blob> pBlob)
+{
+  return minAreaRect(pBlob).size.width;
+}
+
+///////////////////////////
+// BlobGetMinRectBreadth //
+///////////////////////////
+double BlobGetMinRectBreadth::operator()(cv::Ptr<Blob> pBlob)
+{
+  return minAreaRect(pBlob).size.height;
+}
+
+/////////////////////////
+// BlobGetMinRectAngle //
+/////////////////////////
+double BlobGetMinRectAngle::operator()(cv::Ptr<Blob> pBlob)
+{
+  return minAreaRect(pBlob).angle;
+}
+
+////////////////////////
+// BlobGetMinRectArea //
+////////////////////////
+double BlobGetMinRectArea::operator()(cv::Ptr<Blob> pBlob)
+{
+  const cv::RotatedRect rect = minAreaRect(pBlob);
+  return static_cast<double>(rect.size.width) * rect.size.height;
+}
+
 /////////////////////
 // BlobGetXYInside //
 /////////////////////
@@ -824,6 +1105,14 @@ double BlobGetXYInside::operator()(cv::Ptr<Blob> pBlob)
 	return 0;
 }
 
+std::string BlobGetXYInside::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << mPoint.x << ',' << mPoint.y << ')';
+  return key.str();
+}
+
 /////////////////////////
 // BlobGetRelativeArea //
 /////////////////////////
@@ -846,5 +1135,13 @@ double BlobGetRelativeArea::operator()(cv::Ptr<Blob> pBlob)
   return 0.0;
 }
 
+std::string BlobGetRelativeArea::key()
+{
+  std::ostringstream key;
+  beginKey(key, name());
+  key << mTotalArea << ',' << mTheoreticalArea << ')';
+  return key.str();
+}
+
 
 CVBLOBS_END_NAMESPACE
@@ -40,14 +40,14 @@ class BlobOperator
    *
    * The BlobOperator class (and functions that inherit from it) use a data
    * caching strategy to minimize redundant computations for blob properties.
-   * Each Blob has a properties() function that returns a
-   * std::map<std::string, double> that contains cached properties of the Blob.
-   * When a BlobOperator is invoked the Blob's properties() map is checked for a
-   * value using BlobOperator::name() as the key.
-   * If the map contains a value for the BlobOperator::name() then the double
-   * value that maps to the key is returned. Otherwise the property is computed
-   * and then stored in the Blob's properties() map using the
-   * BlobOperator::name() as the key.
+   * Each Blob has a properties() function that returns the BlobProperties
+   * that contains cached properties of the Blob.
+   * When a BlobOperator is invoked the Blob's properties() are checked for a
+   * value in the slot propertyId(), or using BlobOperator::key() as the key
+   * if propertyId() is PROPERTY_NAMED.
+   * If the properties contain a value then it is returned. Otherwise the
+   * property is computed and then stored in the Blob's properties() under
+   * the same slot or key.
    * @param pBlob The blob to operate on.
    * @return the value of the property this functor computes
    */
@@ -59,6 +59,35 @@ class BlobOperator
    * to all other BlobOperator sub-classes.
    */
 	virtual std::string name() = 0;
+
+  /**
+   * @brief The key the result is cached under when propertyId() is
+   * PROPERTY_NAMED, in the Blob's properties() and in the columns of
+   * BlobResult::column().
+   * The default is name(). Operations with parameters add them, like
+   * "BlobGetMoment(2,0)", so instances with different parameters don't share
+   * their results. Images are told apart by the address of their pixels:
+   * after changing the pixels of an image, remove the property with this key.
+   */
+  virtual std::string key();
+
+  /**
+   * @brief The slot of the Blob's properties() the result is cached in.
+   * The built-in operations without parameters return their own PropertyId,
+   * so result() finds their cached value without building name().
+   * The default, PROPERTY_NAMED, caches the result with key() as the key,
+   * for user-defined operations and operations with parameters.
+   */
+  virtual PropertyId propertyId() const;
+
+  /**
+   * @brief Relative cost of evaluating the operation on a blob whose
+   * properties aren't cached yet, one of OperatorCost or anything in between.
+   * BlobFilter evaluates the cheapest conditions first.
+   * The default is the cost of the built-in operation propertyId(), or
+   * COST_PIXELS for operations cached by name.
+   */
+  virtual double cost() const;
   
   /** 
    * @brief Conversion operator for turning the functor into a
@@ -95,6 +124,14 @@ class BlobGetID : public BlobOperator
    * @brief Returns the name of this operation
    */
 	virtual std::string name();
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ID;
+  }
 };
 
 /**
@@ -115,6 +152,14 @@ class BlobGetArea : public BlobOperator
    * @brief Returns the name of this operation
    */
 	virtual std::string name();
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_AREA;
+  }
 };
 
 /**
@@ -135,6 +180,14 @@ class BlobGetPerimeter : public BlobOperator
    * @brief Returns the name of this operation
    */
 	virtual std::string name();
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_PERIMETER;
+  }
 };
 
 /**
@@ -192,6 +245,11 @@ class BlobGetExterior : public BlobOperator
 	{
 		return "BlobGetExterior";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
 
@@ -248,6 +306,11 @@ class BlobGetMean : public BlobOperator
 	{
 		return "BlobGetMean";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
 
@@ -292,6 +355,11 @@ class BlobGetStdDev : public BlobOperator
 	{
 		return "BlobGetStdDev";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
   
@@ -335,6 +403,11 @@ class BlobGetReferencedMean : public BlobOperator
    * @brief Returns the name of this operation
    */
 	virtual std::string name();
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
 
@@ -374,6 +447,14 @@ class BlobGetCompactness : public BlobOperator
 	{
 		return "BlobGetCompactness";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_COMPACTNESS;
+  }
 };
  
 /**
@@ -381,6 +462,7 @@ class BlobGetCompactness : public BlobOperator
  * @brief Functor that computes the length of a Blob
  * (the biggest axis of the blob).
  * @note The computed length is an aproximation to the real length.
+ * BlobGetMinRectLength and BlobGetMaxFeretDiameter measure it exactly.
  * @see https://en.wikipedia.org/wiki/Shape_factor_(image_analysis_and_microscopy)
  * @todo reference for algorithm
  */
@@ -401,6 +483,14 @@ class BlobGetLength : public BlobOperator
 	{
 		return "BlobGetLength";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_LENGTH;
+  }
 };
 
 /**
@@ -408,6 +498,7 @@ class BlobGetLength : public BlobOperator
  * @brief Functor that computes the breadth of a Blob
  * (the smallest axis of the blob).
  * @note The computed bredth is an aproximation to the real breadth.
+ * BlobGetMinRectBreadth and BlobGetMinFeretDiameter measure it exactly.
  * @todo reference for algorithm
  */
 class BlobGetBreadth : public BlobOperator
@@ -427,6 +518,14 @@ class BlobGetBreadth : public BlobOperator
 	{
 		return "BlobGetBreadth";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_BREADTH;
+  }
 };
 
 /**
@@ -451,6 +550,14 @@ class BlobGetDiffX : public BlobOperator
 	{
 		return "BlobGetDiffX";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_DIFF_X;
+  }
 };
 
 /**
@@ -475,6 +582,14 @@ class BlobGetDiffY : public BlobOperator
 	{
 		return "BlobGetDiffY";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_DIFF_Y;
+  }
 };
 
 /** 
@@ -526,6 +641,19 @@ class BlobGetMoment : public BlobOperator
 		return "BlobGetMoment";
 	}
 
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
+
+  /**
+   * @brief Returns the cost of the operation, a moment of the contours
+   */
+  virtual double cost() const
+  {
+    return COST_MOMENTS;
+  }
+
  private:
   
   //! the P,Q moment to calculate
@@ -557,6 +685,14 @@ class BlobGetHullPerimeter : public BlobOperator
 	{
 		return "BlobGetHullPerimeter";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_HULL_PERIMETER;
+  }
 };
 
 /**
@@ -581,6 +717,14 @@ class BlobGetHullArea : public BlobOperator
 	{
 		return "BlobGetHullArea";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_HULL_AREA;
+  }
 };
 
 /**
@@ -604,6 +748,14 @@ class BlobGetMinXatMinY : public BlobOperator
 	{
 		return "BlobGetMinXatMinY";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_X_AT_MIN_Y;
+  }
 };
 
 /**
@@ -627,6 +779,14 @@ class BlobGetMinYatMaxX : public BlobOperator
 	{
 		return "BlobGetMinYatMaxX";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_Y_AT_MAX_X;
+  }
 };
 
 /**
@@ -650,6 +810,14 @@ class BlobGetMaxXatMaxY : public BlobOperator
 	{
 		return "BlobGetMaxXatMaxY";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_X_AT_MAX_Y;
+  }
 };
 
 /**
@@ -673,6 +841,14 @@ class BlobGetMaxYatMinX : public BlobOperator
 	{
 		return "BlobGetMaxYatMinX";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_Y_AT_MIN_X;
+  }
 };
 
 /**
@@ -696,6 +872,14 @@ class BlobGetMinX : public BlobOperator
 	{
 		return "BlobGetMinX";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_X;
+  }
 };
 
 /**
@@ -719,6 +903,14 @@ class BlobGetMaxX : public BlobOperator
 	{
 		return "BlobGetMaxX";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_X;
+  }
 };
 
 /**
@@ -742,6 +934,14 @@ class BlobGetMinY : public BlobOperator
 	{
 		return "BlobGetMinY";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_Y;
+  }
 };
 
 /**
@@ -765,6 +965,14 @@ class BlobGetMaxY : public BlobOperator
 	{
 		return "BlobGetMaxY";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_Y;
+  }
 };
 
 
@@ -790,6 +998,14 @@ class BlobGetElongation : public BlobOperator
 	{
 		return "BlobGetElongation";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ELONGATION;
+  }
 };
 
 /**
@@ -815,6 +1031,14 @@ class BlobGetRoughness : public BlobOperator
 	{
 		return "BlobGetRoughness";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ROUGHNESS;
+  }
 };
 
 /**
@@ -859,6 +1083,19 @@ class BlobGetDistanceFromPoint: public BlobOperator
 		return "BlobGetDistanceFromPoint";
 	}
 
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
+
+  /**
+   * @brief Returns the cost of the operation, the center of the bounding box
+   */
+  virtual double cost() const
+  {
+    return COST_BOUNDS;
+  }
+
  private:
   
   //! point to compute the distance to
@@ -917,6 +1154,11 @@ class BlobGetExternPerimeter : public BlobOperator
 	{
 		return "BlobGetExternPerimeter";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
 
@@ -990,6 +1232,11 @@ class BlobGetExternPerimeterRatio : public BlobOperator
 	{
 		return "BlobGetExternPerimeterRatio";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
 
@@ -1059,6 +1306,11 @@ class BlobGetExternHullPerimeterRatio : public BlobOperator
 	{
 		return "BlobGetExternHullPerimeterRatio";
 	}
+
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
   
  private:
   
@@ -1097,6 +1349,14 @@ class BlobGetXCenter : public BlobOperator
 	{
 		return "BlobGetXCenter";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_X_CENTER;
+  }
 };
 
 
@@ -1125,6 +1385,14 @@ class BlobGetYCenter : public BlobOperator
 	{
 		return "BlobGetYCenter";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_Y_CENTER;
+  }
 };
 
 /**
@@ -1150,6 +1418,14 @@ class BlobGetMajorAxisLength : public BlobOperator
 	{
 		return "BlobGetMajorAxisLength";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAJOR_AXIS_LENGTH;
+  }
 };
 
 /**
@@ -1175,6 +1451,14 @@ class BlobGetAreaElipseRatio : public BlobOperator
 	{
 		return "BlobGetAreaElipseRatio";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_AREA_ELIPSE_RATIO;
+  }
 };
 
 /**
@@ -1200,6 +1484,14 @@ class BlobGetMinorAxisLength : public BlobOperator
 	{
 		return "BlobGetMinorAxisLength";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MINOR_AXIS_LENGTH;
+  }
 };
 
 /**
@@ -1227,6 +1519,14 @@ class BlobGetOrientation : public BlobOperator
 	{
 		return "BlobGetOrientation";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ORIENTATION;
+  }
 };
 
 /**
@@ -1252,6 +1552,14 @@ class BlobGetElipseXCenter : public BlobOperator
 	{
 		return "BlobGetElipseXCenter";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ELIPSE_X_CENTER;
+  }
 };
 
 
@@ -1279,6 +1587,14 @@ class BlobGetElipseYCenter : public BlobOperator
 	{
 		return "BlobGetElipseYCenter";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ELIPSE_Y_CENTER;
+  }
 };
 
 /**
@@ -1304,6 +1620,14 @@ class BlobGetOrientationCos : public BlobOperator
 	{
 		return "BlobGetOrientationCos";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_ORIENTATION_COS;
+  }
 };
 
 
@@ -1330,6 +1654,276 @@ class BlobGetAxisRatio : public BlobOperator
 	{
 		return "BlobGetAxisRatio";
 	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_AXIS_RATIO;
+  }
+};
+
+/**
+ * @class BlobGetMaxFeretDiameter
+ * @brief Functor to calculate the maximum Feret diameter of a Blob, the largest
+ * distance between two points of its convex hull.
+ *
+ * The Feret diameters and the minimum area rectangle are measured by
+ * rotating calipers over the convex hull of the blob, see ConvexHull.h,
+ * between the centres of its contour pixels like BlobGetHullArea.
+ */
+class BlobGetMaxFeretDiameter : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the maximum Feret diameter of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMaxFeretDiameter";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_FERET_DIAMETER;
+  }
+};
+
+/**
+ * @class BlobGetMaxFeretAngle
+ * @brief Functor to calculate the direction of the maximum Feret diameter of a
+ * Blob, in degrees in [0, 180) from the X axis towards the Y axis.
+ */
+class BlobGetMaxFeretAngle : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the direction of the maximum Feret diameter of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMaxFeretAngle";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MAX_FERET_ANGLE;
+  }
+};
+
+/**
+ * @class BlobGetMinFeretDiameter
+ * @brief Functor to calculate the minimum Feret diameter of a Blob, the smallest
+ * width of its convex hull between two parallel lines.
+ */
+class BlobGetMinFeretDiameter : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the minimum Feret diameter of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinFeretDiameter";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_FERET_DIAMETER;
+  }
+};
+
+/**
+ * @class BlobGetMinFeretAngle
+ * @brief Functor to calculate the direction the minimum Feret diameter of a
+ * Blob is measured in, in degrees in [0, 180) from the X axis towards the
+ * Y axis.
+ */
+class BlobGetMinFeretAngle : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the direction of the minimum Feret diameter of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinFeretAngle";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_FERET_ANGLE;
+  }
+};
+
+/**
+ * @class BlobGetMinRectLength
+ * @brief Functor to calculate the length, the longer side, of the rotated
+ * rectangle of smallest area containing a Blob.
+ */
+class BlobGetMinRectLength : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the length of the minimum area rectangle of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinRectLength";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_RECT_LENGTH;
+  }
+};
+
+/**
+ * @class BlobGetMinRectBreadth
+ * @brief Functor to calculate the breadth, the shorter side, of the rotated
+ * rectangle of smallest area containing a Blob.
+ */
+class BlobGetMinRectBreadth : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the breadth of the minimum area rectangle of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinRectBreadth";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_RECT_BREADTH;
+  }
+};
+
+/**
+ * @class BlobGetMinRectAngle
+ * @brief Functor to calculate the direction of the length of the rotated
+ * rectangle of smallest area containing a Blob, in degrees in [0, 180)
+ * from the X axis towards the Y axis.
+ */
+class BlobGetMinRectAngle : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the direction of the minimum area rectangle of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinRectAngle";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_RECT_ANGLE;
+  }
+};
+
+/**
+ * @class BlobGetMinRectArea
+ * @brief Functor to calculate the area of the rotated rectangle of smallest area
+ * containing a Blob.
+ */
+class BlobGetMinRectArea : public BlobOperator
+{
+ public:
+
+  /** 
+   * @brief Returns the area of the minimum area rectangle of \p pBlob
+   * @param pBlob the Blob to use in the operation
+   */
+  virtual double operator()(cv::Ptr<Blob> pBlob);
+    
+  /**
+   * @brief Returns the name of this operation
+   */
+	virtual std::string name()
+	{
+		return "BlobGetMinRectArea";
+	}
+
+  /**
+   * @brief Returns the slot the result is cached in
+   */
+  virtual PropertyId propertyId() const
+  {
+    return PROPERTY_MIN_RECT_AREA;
+  }
 };
 
 /**
@@ -1376,6 +1970,19 @@ class BlobGetXYInside : public BlobOperator
 		return "BlobGetXYInside";
 	}
 
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
+
+  /**
+   * @brief Returns the cost of the operation, a scan of the external contour
+   */
+  virtual double cost() const
+  {
+    return COST_CONTOUR_POINTS;
+  }
+
  private:
 
 	//! punt que considerem
@@ -1423,6 +2030,19 @@ class BlobGetRelativeArea : public BlobOperator
 		return "BlobGetRelativeArea";
 	}
 
+  /**
+   * @brief Returns the key of the cached results, the name and the parameters
+   */
+  virtual std::string key();
+
+  /**
+   * @brief Returns the cost of the operation, the area of the contours
+   */
+  virtual double cost() const
+  {
+    return COST_MOMENTS;
+  }
+
  private:
 
 	//! Total area
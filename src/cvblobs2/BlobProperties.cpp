@@ -0,0 +1,216 @@
+#include <cvblobs2/BlobProperties.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! BlobOperator::name() of the built-in operators, indexed by PropertyId
+const char* const PROPERTY_NAMES[] =
+{
+  "BlobGetID",
+  "BlobGetArea",
+  "BlobGetPerimeter",
+  "BlobGetCompactness",
+  "BlobGetLength",
+  "BlobGetBreadth",
+  "BlobGetDiffX",
+  "BlobGetDiffY",
+  "BlobGetHullPerimeter",
+  "BlobGetHullArea",
+  "BlobGetMinXatMinY",
+  "BlobGetMinYatMaxX",
+  "BlobGetMaxXatMaxY",
+  "BlobGetMaxYatMinX",
+  "BlobGetMinX",
+  "BlobGetMaxX",
+  "BlobGetMinY",
+  "BlobGetMaxY",
+  "BlobGetElongation",
+  "BlobGetRoughness",
+  "BlobGetXCenter",
+  "BlobGetYCenter",
+  "BlobGetMajorAxisLength",
+  "BlobGetAreaElipseRatio",
+  "BlobGetMinorAxisLength",
+  "BlobGetOrientation",
+  "BlobGetElipseXCenter",
+  "BlobGetElipseYCenter",
+  "BlobGetOrientationCos",
+  "BlobGetAxisRatio",
+  "BlobGetMaxFeretDiameter",
+  "BlobGetMaxFeretAngle",
+  "BlobGetMinFeretDiameter",
+  "BlobGetMinFeretAngle",
+  "BlobGetMinRectLength",
+  "BlobGetMinRectBreadth",
+  "BlobGetMinRectAngle",
+  "BlobGetMinRectArea"
+};
+CVBLOBS_STATIC_ASSERT(sizeof(PROPERTY_NAMES) / sizeof(PROPERTY_NAMES[0]) ==
+                      PROPERTY_COUNT,
+                      PROPERTY_NAMES_must_have_a_name_per_PropertyId);
+
+//! Orders the built-in operators by name
+struct PropertyNameLess
+{
+  bool operator()(PropertyId lhs, PropertyId rhs) const
+  {
+    return std::strcmp(PROPERTY_NAMES[lhs], PROPERTY_NAMES[rhs]) < 0;
+  }
+
+  bool operator()(PropertyId lhs, const std::string& rhs) const
+  {
+    return rhs.compare(PROPERTY_NAMES[lhs]) > 0;
+  }
+};
+
+//! Returns the ids of the built-in operators sorted by name
+std::vector<PropertyId> sortedPropertyIds()
+{
+  std::vector<PropertyId> ids(PROPERTY_COUNT);
+  for (int i = 0; i < PROPERTY_COUNT; ++i)
+  {
+    ids[i] = static_cast<PropertyId>(i);
+  }
+  std::sort(ids.begin(), ids.end(), PropertyNameLess());
+  return ids;
+}
+
+//! ids of the built-in operators sorted by name, searched by propertyId().
+//! Built during the static initialization, before any thread can look it up.
+const std::vector<PropertyId> PROPERTY_IDS_BY_NAME = sortedPropertyIds();
+
+} // end anonymous namespace
+
+BlobProperties::BlobProperties()
+    : mValid(),
+      mNamed()
+{
+  std::fill(mValues, mValues + PROPERTY_COUNT, 0.0);
+}
+
+PropertyId BlobProperties::propertyId(const std::string& name)
+{
+  std::vector<PropertyId>::const_iterator iter =
+      std::lower_bound(PROPERTY_IDS_BY_NAME.begin(),
+                       PROPERTY_IDS_BY_NAME.end(),
+                       name,
+                       PropertyNameLess());
+  if (iter == PROPERTY_IDS_BY_NAME.end() || name != PROPERTY_NAMES[*iter])
+  {
+    return PROPERTY_NAMED;
+  }
+  return *iter;
+}
+
+const char* BlobProperties::propertyName(PropertyId id)
+{
+  return PROPERTY_NAMES[id];
+}
+
+bool BlobProperties::find(const std::string& name, double& value) const
+{
+  const PropertyId id = propertyId(name);
+  if (id != PROPERTY_NAMED)
+  {
+    return find(id, value);
+  }
+
+  std::map<std::string, double>::const_iterator iter = mNamed.find(name);
+  if (iter == mNamed.end())
+  {
+    return false;
+  }
+  value = iter->second;
+  return true;
+}
+
+void BlobProperties::set(const std::string& name, double value)
+{
+  const PropertyId id = propertyId(name);
+  if (id != PROPERTY_NAMED)
+  {
+    set(id, value);
+    return;
+  }
+  mNamed[name] = value;
+}
+
+void BlobProperties::reset(const std::string& name)
+{
+  const PropertyId id = propertyId(name);
+  if (id != PROPERTY_NAMED)
+  {
+    reset(id);
+    return;
+  }
+  mNamed.erase(name);
+}
+
+std::size_t BlobProperties::count(const std::string& name) const
+{
+  double value = 0.0;
+  return find(name, value) ? 1 : 0;
+}
+
+double& BlobProperties::operator[](const std::string& name)
+{
+  const PropertyId id = propertyId(name);
+  if (id == PROPERTY_NAMED)
+  {
+    return mNamed[name];
+  }
+  if (!mValid.test(id))
+  {
+    set(id, 0.0);
+  }
+  return mValues[id];
+}
+
+std::size_t BlobProperties::erase(const std::string& name)
+{
+  const std::size_t erased = count(name);
+  reset(name);
+  return erased;
+}
+
+std::size_t BlobProperties::size() const
+{
+  return mValid.count() + mNamed.size();
+}
+
+bool BlobProperties::empty() const
+{
+  return mValid.none() && mNamed.empty();
+}
+
+void BlobProperties::toMap(std::map<std::string, double>& properties) const
+{
+  properties = mNamed;
+  for (int i = 0; i < PROPERTY_COUNT; ++i)
+  {
+    if (mValid.test(i))
+    {
+      properties[PROPERTY_NAMES[i]] = mValues[i];
+    }
+  }
+}
+
+void BlobProperties::clear()
+{
+  mValid.reset();
+  mNamed.clear();
+}
+
+void BlobProperties::swap(BlobProperties& other)
+{
+  std::swap_ranges(mValues, mValues + PROPERTY_COUNT, other.mValues);
+  std::swap(mValid, other.mValid);
+  mNamed.swap(other.mNamed);
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,163 @@
+/**
+ * @brief Cache of the properties computed on a Blob.
+ */
+#ifndef _CVBLOBS2_BLOBPROPERTIES_H_
+#define _CVBLOBS2_BLOBPROPERTIES_H_
+
+#include <bitset>
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class BlobProperties
+ * @brief Values of the properties computed on a Blob, see
+ * BlobOperator::result().
+ *
+ * The properties of the built-in operators are stored in a fixed array
+ * indexed by PropertyId, with a bit per slot telling whether it holds a
+ * value. Looking them up doesn't allocate nor compare strings. The other
+ * properties, from user-defined operators and operators with parameters, are
+ * stored in a std::map keyed by name.
+ *
+ * The functions taking a name also accept the name of a built-in operator,
+ * in which case they use its slot, so both ways of reaching a property agree.
+ *
+ * Blob::properties() used to be a std::map<std::string, double>. Code
+ * written against the map keeps working with count(), operator[](), erase()
+ * and size(), and toMap() copies every property, built-in ones included,
+ * into such a map for code iterating over them.
+ */
+class BlobProperties
+{
+ public:
+
+  BlobProperties();
+
+  /**
+   * @brief Returns the PropertyId of the built-in operator named \p name, or
+   * PROPERTY_NAMED if there is none
+   */
+  static PropertyId propertyId(const std::string& name);
+
+  /**
+   * @brief Returns the BlobOperator::name() of the built-in operator \p id
+   * @pre 0 <= \p id < PROPERTY_COUNT
+   */
+  static const char* propertyName(PropertyId id);
+
+  /**
+   * @brief Returns true and sets \p value if the property \p id is cached
+   * @pre 0 <= \p id < PROPERTY_COUNT
+   */
+  inline bool find(PropertyId id, double& value) const;
+
+  /**
+   * @brief Returns true and sets \p value if the property \p name is cached
+   */
+  bool find(const std::string& name, double& value) const;
+
+  /**
+   * @brief Caches \p value as the property \p id
+   * @pre 0 <= \p id < PROPERTY_COUNT
+   */
+  inline void set(PropertyId id, double value);
+
+  /**
+   * @brief Caches \p value as the property \p name
+   */
+  void set(const std::string& name, double value);
+
+  /**
+   * @brief Removes the property \p id
+   * @pre 0 <= \p id < PROPERTY_COUNT
+   */
+  inline void reset(PropertyId id);
+
+  /**
+   * @brief Removes the property \p name
+   */
+  void reset(const std::string& name);
+
+  /**
+   * @brief Returns 1 if the property \p name is cached, else 0, like
+   * std::map::count()
+   */
+  std::size_t count(const std::string& name) const;
+
+  /**
+   * @brief Returns the value of the property \p name, caching 0 first if
+   * there is none, like std::map::operator[]()
+   */
+  double& operator[](const std::string& name);
+
+  /**
+   * @brief Removes the property \p name and returns 1 if it was cached,
+   * else 0, like std::map::erase()
+   */
+  std::size_t erase(const std::string& name);
+
+  /**
+   * @brief Returns the number of cached properties
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Returns true if no property is cached
+   */
+  bool empty() const;
+
+  /**
+   * @brief Sets \p properties to every cached property keyed by name, the
+   * built-in ones under propertyName()
+   */
+  void toMap(std::map<std::string, double>& properties) const;
+
+  /**
+   * @brief Removes every property
+   */
+  void clear();
+
+  /**
+   * @brief Swaps the properties of this cache with the ones of \p other
+   */
+  void swap(BlobProperties& other);
+
+ private:
+
+  //! properties of the built-in operators, valid where mValid is set
+  double mValues[PROPERTY_COUNT];
+  std::bitset<PROPERTY_COUNT> mValid;
+
+  //! properties of the other operators
+  std::map<std::string, double> mNamed;
+};
+
+inline bool BlobProperties::find(PropertyId id, double& value) const
+{
+  if (!mValid.test(id))
+  {
+    return false;
+  }
+  value = mValues[id];
+  return true;
+}
+
+inline void BlobProperties::set(PropertyId id, double value)
+{
+  mValues[id] = value;
+  mValid.set(id);
+}
+
+inline void BlobProperties::reset(PropertyId id)
+{
+  mValid.reset(id);
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBPROPERTIES_H_
@@ -9,14 +9,290 @@
 #include <stdio.h>
 #include <functional>
 #include <algorithm>
+#include <utility>
 
 #include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobArena.h>
+#include <cvblobs2/BlobContour.h>
+#include <cvblobs2/BlobFilter.h>
 #include <cvblobs2/BlobOperators.h>
 
 CVBLOBS_BEGIN_NAMESPACE
 
+namespace {
+
+//! number of chunks of blobs per thread, the cost of a blob varies a lot
+//! with its size so small chunks balance the load between threads
+const int STRIPES_PER_THREAD = 16;
+
+/**
+ * @brief Result of an operator on a blob
+ */
+class OperatorResult
+{
+ public:
+
+  explicit OperatorResult(BlobOperator* pOperator)
+      : mpOperator(pOperator)
+  {}
+
+  double operator()(const cv::Ptr<Blob>& pBlob) const
+  {
+    return mpOperator->result(pBlob);
+  }
+
+ private:
+
+  BlobOperator* mpOperator;
+};
+
+/**
+ * @brief Result of a filter on a blob, 1 if the blob passes it
+ */
+class FilterResult
+{
+ public:
+
+  explicit FilterResult(const BlobFilter& blobFilter)
+      : mFilter(blobFilter)
+  {}
+
+  unsigned char operator()(const cv::Ptr<Blob>& pBlob) const
+  {
+    return mFilter(pBlob) ? 1 : 0;
+  }
+
+ private:
+
+  const BlobFilter& mFilter;
+};
+
+//! A blob or a contour of the blob \p second
+typedef std::pair<const void*, std::size_t> SharedObject;
+
+//! Adds \p pContour, a contour of the blob \p i, to \p sharedObjects
+void addSharedContour(const cv::Ptr<BlobContour>& pContour,
+                      std::size_t i,
+                      std::vector<SharedObject>& sharedObjects)
+{
+  if (!pContour.empty())
+  {
+    sharedObjects.push_back(
+        SharedObject(static_cast<const BlobContour*>(pContour), i));
+  }
+}
+
+//! Returns the root of the group of \p i, halving the path to it
+std::size_t groupRoot(std::vector<std::size_t>& parents, std::size_t i)
+{
+  while (parents[i] != i)
+  {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+//! Joins the groups of \p i and \p j, the smaller index being the root
+void uniteGroups(std::vector<std::size_t>& parents,
+                 std::size_t i,
+                 std::size_t j)
+{
+  i = groupRoot(parents, i);
+  j = groupRoot(parents, j);
+  if (i < j)
+  {
+    parents[j] = i;
+  }
+  else if (j < i)
+  {
+    parents[i] = j;
+  }
+}
+
+/**
+ * @brief Evaluates a function on some groups of blobs, results[i] is the
+ * result of blobs[i]. The blobs of a group are evaluated one after the
+ * other.
+ */
+template <typename Function, typename ResultType>
+class BlobEvaluator : public cv::ParallelLoopBody
+{
+ public:
+
+  BlobEvaluator(const BlobContainerType& blobs,
+                const std::vector<std::size_t>& groupStarts,
+                const std::vector<std::size_t>& groupBlobs,
+                const Function& function,
+                std::vector<ResultType>& results)
+      : mBlobs(blobs),
+        mGroupStarts(groupStarts),
+        mGroupBlobs(groupBlobs),
+        mFunction(function),
+        mResults(results)
+  {}
+
+  virtual void operator()(const cv::Range& range) const
+  {
+    for (int g = range.start; g < range.end; ++g)
+    {
+      for (std::size_t k = mGroupStarts[g]; k < mGroupStarts[g + 1]; ++k)
+      {
+        const std::size_t i = mGroupBlobs[k];
+        mResults[i] = mFunction(mBlobs[i]);
+      }
+    }
+  }
+
+ private:
+
+  const BlobContainerType& mBlobs;
+  //! the blobs of the group g are mGroupBlobs[mGroupStarts[g]] up to
+  //! mGroupBlobs[mGroupStarts[g + 1]]
+  const std::vector<std::size_t>& mGroupStarts;
+  const std::vector<std::size_t>& mGroupBlobs;
+  const Function& mFunction;
+  std::vector<ResultType>& mResults;
+};
+
+/**
+ * @brief Evaluates \p function on all of \p blobs on several threads.
+ * Evaluating a blob writes its properties and the caches of its contours.
+ * The blobs that share a contour, external, internal or joined, or that are
+ * in \p blobs several times, are grouped with a union-find and every group
+ * is evaluated by a single thread. Copies of a Blob share its contours, and
+ * Blob::joinBlob() shares the contours of the joined blob.
+ * @pre \p results has blobs.size() elements
+ */
+template <typename Function, typename ResultType>
+void evaluateParallel(const BlobContainerType& blobs,
+                      const Function& function,
+                      std::vector<ResultType>& results)
+{
+  const std::size_t num_blobs = blobs.size();
+
+  // every blob and contour with the blob it belongs to, ordered by address
+  std::vector<SharedObject> shared_objects;
+  shared_objects.reserve(2 * num_blobs);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    cv::Ptr<Blob> p_blob = blobs[i];
+    shared_objects.push_back(SharedObject(static_cast<const Blob*>(p_blob), i));
+    addSharedContour(p_blob->externalContour(), i, shared_objects);
+    for (std::size_t k = 0; k < p_blob->numInternalContours(); ++k)
+    {
+      addSharedContour(p_blob->internalContour(k), i, shared_objects);
+    }
+    for (std::size_t k = 0; k < p_blob->numJoinedContours(); ++k)
+    {
+      addSharedContour(p_blob->joinedContour(k), i, shared_objects);
+    }
+  }
+  std::sort(shared_objects.begin(), shared_objects.end());
+
+  // the blobs of an object are in the same group
+  std::vector<std::size_t> parents(num_blobs);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    parents[i] = i;
+  }
+  for (std::size_t k = 1; k < shared_objects.size(); ++k)
+  {
+    if (shared_objects[k].first == shared_objects[k - 1].first)
+    {
+      uniteGroups(parents,
+                  shared_objects[k - 1].second,
+                  shared_objects[k].second);
+    }
+  }
+
+  // the blobs of every group one after the other, the groups in the order
+  // of their first blob, their root, to keep neighbouring blobs, which tend
+  // to have similar costs, together
+  std::vector<std::size_t> group_sizes(num_blobs, 0);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    parents[i] = groupRoot(parents, i);
+    ++group_sizes[parents[i]];
+  }
+  std::vector<std::size_t> group_starts(1, 0);
+  std::vector<std::size_t> group_ends(num_blobs, 0);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    if (group_sizes[i] > 0)
+    {
+      group_ends[i] = group_starts.back();
+      group_starts.push_back(group_starts.back() + group_sizes[i]);
+    }
+  }
+  std::vector<std::size_t> group_blobs(num_blobs);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    group_blobs[group_ends[parents[i]]++] = i;
+  }
+
+  const int num_groups = static_cast<int>(group_starts.size() - 1);
+  const int num_stripes = std::min(num_groups,
+                                   cv::getNumThreads() * STRIPES_PER_THREAD);
+  cv::parallel_for_(cv::Range(0, num_groups),
+                    BlobEvaluator<Function, ResultType>(blobs,
+                                                        group_starts,
+                                                        group_blobs,
+                                                        function,
+                                                        results),
+                    num_stripes);
+}
+
+/**
+ * @brief Orders (result, index) pairs by rank: by result, then by index
+ */
+class RankOrder
+{
+ public:
+
+  explicit RankOrder(bool bDescending)
+      : mbDescending(bDescending)
+  {}
+
+  bool operator()(const std::pair<double, std::size_t>& lhs,
+                  const std::pair<double, std::size_t>& rhs) const
+  {
+    if (lhs.first != rhs.first)
+    {
+      return mbDescending ? lhs.first > rhs.first : lhs.first < rhs.first;
+    }
+    return lhs.second < rhs.second;
+  }
+
+ private:
+
+  bool mbDescending;
+};
+
+/**
+ * @brief Returns the indices i, in increasing order, where \p selectedBlobs[i]
+ * isn't 0
+ */
+std::vector<std::size_t> selectedIndices(
+    const std::vector<unsigned char>& selectedBlobs)
+{
+  std::vector<std::size_t> selected_indices;
+  for (std::size_t i = 0; i < selectedBlobs.size(); ++i)
+  {
+    if (selectedBlobs[i])
+    {
+      selected_indices.push_back(i);
+    }
+  }
+  return selected_indices;
+}
+
+} // end anonymous namespace
+
 BlobResult::BlobResult()
-    : mBlobs()
+    : mBlobs(),
+      mFeatures(),
+      mpArena(NULL)
 {}
 
 /**
@@ -102,7 +378,9 @@ BlobResult::BlobResult()
 - MODIFICATION: Date. Author. Description.
 */
 BlobResult::BlobResult(const BlobResult& source)
-    : mBlobs(source.mBlobs)
+    : mBlobs(source.mBlobs),
+      mFeatures(source.mFeatures),
+      mpArena(NULL)
 {}
 
 
@@ -163,10 +441,13 @@ BlobResult& BlobResult::operator=(const BlobResult& source)
 {
 	if (this != &source)
 	{
-    // use copy-swap idiom here to be safe in the face of allocation exceptions
-    BlobResult tmp(source);
-    // swap contents of tmp with this
-    swap(tmp);
+    // use copy-swap idiom here to be safe in the face of allocation exceptions.
+    // Only the blobs and their columns are swapped: a temporary holding the
+    // arena would clear it, under the blobs of both results, when destroyed.
+    BlobContainerType tmp_blobs(source.mBlobs);
+    FeatureTable tmp_features(source.mFeatures);
+    std::swap(mBlobs, tmp_blobs);
+    mFeatures.swap(tmp_features);
 	}
 	return *this;
 }
@@ -234,6 +515,9 @@ BlobResult BlobResult::operator+(const BlobResult& source) const
   // resulting in a more efficient implementation.
 	BlobResult result;
   concatVectors(result.mBlobs, source.mBlobs, mBlobs);
+  // only the columns both results have can be kept
+  result.mFeatures = source.mFeatures;
+  result.mFeatures.append(mFeatures);
 	return result;
 }
 
@@ -246,9 +530,12 @@ BlobResult& BlobResult::operator+=(const BlobResult& source)
     // use copy-swap idiom here to be safe in the face of allocation exceptions
     BlobContainerType tmp_blobs;
     concatVectors(tmp_blobs, source.mBlobs, mBlobs);
+    FeatureTable tmp_features(source.mFeatures);
+    tmp_features.append(mFeatures);
     
     // swap the containers so that mBlobs can be safely updated 
     std::swap(mBlobs, tmp_blobs);
+    mFeatures.swap(tmp_features);
   }
   return *this;
 }
@@ -256,6 +543,8 @@ BlobResult& BlobResult::operator+=(const BlobResult& source)
 void BlobResult::swap(BlobResult& other)
 {
   std::swap(mBlobs, other.mBlobs);
+  mFeatures.swap(other.mFeatures);
+  std::swap(mpArena, other.mpArena);
 }
 
 /**************************************************************************
@@ -277,6 +566,8 @@ void BlobResult::swap(BlobResult& other)
 void BlobResult::addBlob(cv::Ptr<Blob> blob)
 {
 	mBlobs.push_back(blob);
+  // the columns can't be completed without computing the properties
+  mFeatures.clear();
 }
 
 /**
@@ -305,15 +596,34 @@ void BlobResult::addBlob(cv::Ptr<Blob> blob)
 - CREATION DATE: 25-05-2005.
 - MODIFICATION: Date. Author. Description.
 */
-std::vector<double> BlobResult::result(BlobOperator* pOperator) const
+std::vector<double> BlobResult::result(BlobOperator* pOperator,
+                                       bool bParallel /*= false*/) const
 {
-  std::vector<double> result;
 	if (numBlobs() <= 0)
 	{
-		return result;
+		return std::vector<double>();
 	}
+  return column(pOperator, bParallel);
+}
+
+const std::vector<double>& BlobResult::column(BlobOperator* pOperator,
+                                              bool bParallel /*= false*/) const
+{
+  const std::string key = pOperator->key();
+  const std::vector<double>* p_column = mFeatures.find(key);
+  if (p_column != NULL)
+  {
+    return *p_column;
+  }
 
   // make enough space for each blob's result
+  std::vector<double> result;
+  if (bParallel && numBlobs() > 1)
+  {
+    result.resize(numBlobs());
+    evaluateParallel(mBlobs, OperatorResult(pOperator), result);
+    return mFeatures.set(key, result);
+  }
   result.reserve(numBlobs());
 
   // evaluate pOperator for each blob
@@ -323,7 +633,30 @@ std::vector<double> BlobResult::result(BlobOperator* pOperator) const
   {
     result.push_back( pOperator->result(*it) );
 	}
-	return result;
+  return mFeatures.set(key, result);
+}
+
+cv::Mat BlobResult::results(const std::vector<BlobOperator*>& operators) const
+{
+  cv::Mat results;
+  if (mBlobs.empty() || operators.empty())
+  {
+    return results;
+  }
+
+  results.create(static_cast<int>(mBlobs.size()),
+                 static_cast<int>(operators.size()),
+                 CV_64FC1);
+  for (std::size_t i = 0; i < mBlobs.size(); ++i)
+  {
+    const cv::Ptr<Blob>& p_blob = mBlobs[i];
+    double* p_row = results.ptr<double>(static_cast<int>(i));
+    for (std::size_t j = 0; j < operators.size(); ++j)
+    {
+      p_row[j] = operators[j]->result(p_blob);
+    }
+  }
+  return results;
 }
 
 /**
@@ -418,75 +751,184 @@ void BlobResult::filter(BlobResult& dst,
                         BlobOperator* pOperator,
                         FilterCondition condition, 
                         double lowLimit,
-                        double highLimit /*=0*/)
+                        double highLimit /*=0*/,
+                        bool bParallel /*= false*/)
 {
 	if (pOperator == NULL || numBlobs() == 0)
   {
     return;
   }
   
-  bool b_inline_filter = (&dst == this);
+  std::vector<unsigned char> selected_blobs;
+  selectBlobs(selected_blobs,
+              filterAction,
+              pOperator,
+              condition,
+              lowLimit,
+              highLimit,
+              bParallel);
+  keepBlobs(dst, selected_blobs);
+}
+
+void BlobResult::filter(BlobResult& dst,
+                        FilterAction filterAction,
+                        const BlobFilter& blobFilter,
+                        bool bParallel /*= false*/)
+{
+  if (numBlobs() == 0)
+  {
+    return;
+  }
+
+  std::vector<unsigned char> selected_blobs;
+  selectBlobs(selected_blobs, filterAction, blobFilter, bParallel);
+  keepBlobs(dst, selected_blobs);
+}
+
+void BlobResult::keepBlobs(BlobResult& dst,
+                           const std::vector<unsigned char>& selectedBlobs)
+{
+  const std::size_t num_blobs = numBlobs();
+
+  // remove from origin for inline operation, the columns with the blobs.
+  // The selected blobs are moved down in one pass, keeping their order
+  if (&dst == this)
+  {
+    std::size_t num_selected = 0;
+    for (std::size_t i = 0; i < num_blobs; ++i)
+    {
+      if (selectedBlobs[i])
+      {
+        mBlobs[num_selected++] = mBlobs[i];
+      }
+    }
+    mBlobs.resize(num_selected);
+    mFeatures.compact(selectedBlobs);
+    return;
+  }
 
-  std::size_t num_blobs_erased = 0;
+  // add to dst if not inline operation, the columns only if all of the
+  // blobs of dst have them
+  const std::vector<std::size_t> selected_indices =
+      selectedIndices(selectedBlobs);
+  const bool b_dst_empty = dst.mBlobs.empty();
+  FeatureTable selected_features;
+  mFeatures.select(selected_indices, selected_features);
+  dst.mBlobs.reserve(dst.mBlobs.size() + selected_indices.size());
+  for (std::size_t i = 0; i < selected_indices.size(); ++i)
+  {
+    dst.mBlobs.push_back(mBlobs[selected_indices[i]]);
+  }
+  if (b_dst_empty)
+  {
+    dst.mFeatures.swap(selected_features);
+  }
+  else
+  {
+    dst.mFeatures.append(selected_features);
+  }
+}
+
+std::vector<std::size_t> BlobResult::filterIndices(
+    FilterAction filterAction,
+    BlobOperator* pOperator,
+    FilterCondition condition,
+    double lowLimit,
+    double highLimit /*= 0*/,
+    bool bParallel /*= false*/) const
+{
+	if (pOperator == NULL || numBlobs() == 0)
+  {
+    return std::vector<std::size_t>();
+  }
+
+  std::vector<unsigned char> selected_blobs;
+  selectBlobs(selected_blobs,
+              filterAction,
+              pOperator,
+              condition,
+              lowLimit,
+              highLimit,
+              bParallel);
+  return selectedIndices(selected_blobs);
+}
+
+std::vector<std::size_t> BlobResult::filterIndices(
+    FilterAction filterAction,
+    const BlobFilter& blobFilter,
+    bool bParallel /*= false*/) const
+{
+  if (numBlobs() == 0)
+  {
+    return std::vector<std::size_t>();
+  }
+
+  std::vector<unsigned char> selected_blobs;
+  selectBlobs(selected_blobs, filterAction, blobFilter, bParallel);
+  return selectedIndices(selected_blobs);
+}
+
+void BlobResult::selectBlobs(std::vector<unsigned char>& selectedBlobs,
+                             FilterAction filterAction,
+                             BlobOperator* pOperator,
+                             FilterCondition condition,
+                             double lowLimit,
+                             double highLimit,
+                             bool bParallel) const
+{
 	bool b_result_passed = false;
   bool b_selected_blob = false;
   
 	// evaluate blobs using specified operator
-  std::vector<double> blob_results = result(pOperator);
+  const std::vector<double>& blob_results = column(pOperator, bParallel);
   const std::size_t num_results = blob_results.size();
-  double result = 0.0;
+  selectedBlobs.assign(num_results, 0);
   
 	for (std::size_t i = 0; i < num_results; ++i)
 	{
-    result = blob_results[i];
-		switch (condition)
-		{
-			case CONDITION_EQUAL:
-				b_result_passed = (result == lowLimit);
-				break;
-			case CONDITION_NOT_EQUAL:
-				b_result_passed = (result != lowLimit);
-				break;
-			case CONDITION_GREATER:
-				b_result_passed = (result > lowLimit);
-				break;
-			case CONDITION_LESS:
-				b_result_passed = (result < lowLimit);
-				break;
-			case CONDITION_GREATER_OR_EQUAL:
-				b_result_passed = (result >= lowLimit);
-				break;
-			case CONDITION_LESS_OR_EQUAL:
-				b_result_passed = (result <= lowLimit);
-				break;
-			case CONDITION_INSIDE:
-				b_result_passed = (result >= lowLimit) && (result <= highLimit); 
-				break;
-			case CONDITION_OUTSIDE:
-				b_result_passed = (result < lowLimit) || (result > highLimit); 
-				break;
-		} // end switch condition
+    b_result_passed = passesCondition(blob_results[i],
+                                      condition,
+                                      lowLimit,
+                                      highLimit);
 		
 		// blob is selected?
 		b_selected_blob = ( (b_result_passed && filterAction == ACTION_INCLUDE ) || 
                         (!b_result_passed && filterAction == ACTION_EXCLUDE ) );
 
-		// add to dst if not inline operation
-    // (for inline operation we don't have to do anything)
-		if (!b_inline_filter && b_selected_blob)
-		{
-			dst.addBlob( mBlobs[i - num_blobs_erased] );
-		}
-		// remove from origin for inline operation
-    // (for not inline we don't have to do anything)
-		if (b_inline_filter && !b_selected_blob)
-		{
-			mBlobs.erase(mBlobs.begin() + i - num_blobs_erased);
-			++num_blobs_erased;
-		}
+    selectedBlobs[i] = b_selected_blob;
 	} // end for each blob
 }
 
+void BlobResult::selectBlobs(std::vector<unsigned char>& selectedBlobs,
+                             FilterAction filterAction,
+                             const BlobFilter& blobFilter,
+                             bool bParallel) const
+{
+  const std::size_t num_blobs = numBlobs();
+  selectedBlobs.assign(num_blobs, 0);
+
+  // evaluate the whole filter on one blob before moving to the next one
+  if (bParallel && num_blobs > 1)
+  {
+    evaluateParallel(mBlobs, FilterResult(blobFilter), selectedBlobs);
+  }
+  else
+  {
+    for (std::size_t i = 0; i < num_blobs; ++i)
+    {
+      selectedBlobs[i] = blobFilter(mBlobs[i]);
+    }
+  }
+
+  if (filterAction == ACTION_EXCLUDE)
+  {
+    for (std::size_t i = 0; i < num_blobs; ++i)
+    {
+      selectedBlobs[i] = !selectedBlobs[i];
+    }
+  }
+}
+
 
 /**
 - FUNCI: GetBlob
@@ -555,33 +997,68 @@ cv::Ptr<Blob> BlobResult::nthBlob(BlobOperator* pCriteria,
 		return NULL;
 	}
 
-  // @todo make this more efficient
+  // the n-th blob is the last of the best nBlob + 1
+  const std::vector<RankedBlob> ranked_blobs = topK(pCriteria, nBlob + 1);
+  if (ranked_blobs.size() <= nBlob)
+  {
+    return NULL;
+  }
+  return ranked_blobs.back().pBlob;
+}
 
-	// evaluate the blobs with the pCriteria function
-  std::vector<double> blob_results = result(pCriteria);
-  std::vector<double> blob_results_sorted(numBlobs());
+std::vector<RankedBlob> BlobResult::topK(BlobOperator* pCriteria,
+                                         std::size_t k,
+                                         bool bDescending /*= true*/) const
+{
+  std::vector<RankedBlob> ranked_blobs;
+  const std::size_t num_blobs = numBlobs();
+  k = std::min(k, num_blobs);
+  if (pCriteria == NULL || k == 0)
+  {
+    return ranked_blobs;
+  }
 
-  // obtain the first nBlob results in descending order
-	std::partial_sort_copy( blob_results.begin(), 
-                          blob_results.end(),
-                          blob_results_sorted.begin(), 
-                          blob_results_sorted.end(),
-                          std::greater<double>() );
+  const std::vector<double>* p_column = mFeatures.find(pCriteria->key());
 
-	double nth_value = blob_results_sorted[nBlob];
-  std::size_t blob_index = 0;
-  
-	// seek first blob that has the value n
-	for (std::vector<double>::const_iterator iter = blob_results.begin();
-       iter != blob_results.begin();
-       ++iter, ++blob_index)
-	{
-		if (*iter == nth_value)
-		{
-			return blob(blob_index);
-		}
-	}
-  return NULL;
+  // heap of the best k (result, index) so far, the worst of them on top
+  typedef std::pair<double, std::size_t> ResultIndex;
+  const RankOrder rank_order(bDescending);
+  std::vector<ResultIndex> best;
+  best.reserve(k);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    const double value = (p_column != NULL) ?
+                         (*p_column)[i] :
+                         pCriteria->result(mBlobs[i]);
+    if (value != value)
+    {
+      // NaN can't be ranked
+      continue;
+    }
+
+    const ResultIndex result_index(value, i);
+    if (best.size() < k)
+    {
+      best.push_back(result_index);
+      std::push_heap(best.begin(), best.end(), rank_order);
+    }
+    else if (rank_order(result_index, best.front()))
+    {
+      std::pop_heap(best.begin(), best.end(), rank_order);
+      best.back() = result_index;
+      std::push_heap(best.begin(), best.end(), rank_order);
+    }
+  }
+  std::sort_heap(best.begin(), best.end(), rank_order);
+
+  ranked_blobs.resize(best.size());
+  for (std::size_t j = 0; j < best.size(); ++j)
+  {
+    ranked_blobs[j].index = best[j].second;
+    ranked_blobs[j].value = best[j].first;
+    ranked_blobs[j].pBlob = mBlobs[best[j].second];
+  }
+  return ranked_blobs;
 }
 
 /**
@@ -608,6 +1085,16 @@ cv::Ptr<Blob> BlobResult::nthBlob(BlobOperator* pCriteria,
 void BlobResult::clearBlobs()
 {
 	mBlobs.clear();
+  mFeatures.clear();
+  if (mpArena != NULL)
+  {
+    mpArena->clear();
+  }
+}
+
+void BlobResult::setArena(BlobArena* pArena)
+{
+  mpArena = pArena;
 }
 
 /**************************************************************************
@@ -685,6 +1172,7 @@ void BlobResult::removeProperty(const std::string& propertyName)
   {
     (*iter)->resetProperty(propertyName);
 	}
+  mFeatures.remove(propertyName);
 }
 
 CVBLOBS_END_NAMESPACE
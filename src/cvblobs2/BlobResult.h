@@ -2,10 +2,27 @@
 #define _CVBLOBS2_BLOBRESULT_H_
 
 #include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/FeatureTable.h>
+#include <cstddef>
 #include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
 
 CVBLOBS_BEGIN_NAMESPACE
 
+/**
+ * @brief A blob of a BlobResult with the value of the criteria it was ranked
+ * by, see BlobResult::topK()
+ */
+struct RankedBlob
+{
+  //! index of the blob in the BlobResult
+  std::size_t index;
+  //! result of the criteria on the blob
+  double value;
+  cv::Ptr<Blob> pBlob;
+};
+
 /**
  * @class BlobResult
  * @brief Class to calculate the blobs of an image and calculate some properties
@@ -50,7 +67,49 @@ class BlobResult
 
 	//! Calcula un valor sobre tots els blobs de la classe retornant un std::vector<double>
 	//! Computes some property on all the blobs of the class
-  std::vector<double> result(BlobOperator* pOperator) const;
+  //! If \p bParallel is true the blobs are evaluated on several threads, see
+  //! column()
+  std::vector<double> result(BlobOperator* pOperator,
+                             bool bParallel = false) const;
+
+  /**
+   * @brief Returns the values of \p pOperator for all the blobs, in the order
+   * of the blobs, from the column store of the result.
+   * The column is computed the first time and kept, in sync with the blobs,
+   * by filter() and the concatenation operators. Adding a blob drops the
+   * columns. Columns are named after BlobOperator::key(), so operators with
+   * different parameters have their own. removeProperty() drops the column
+   * of the property, properties reset directly on a Blob aren't seen.
+   * Not thread safe, even though it's const.
+   *
+   * If \p bParallel is true and the column isn't known yet, the blobs are
+   * split in small chunks evaluated on several threads, so a few big blobs
+   * don't keep one thread busy while the others wait. The values are the
+   * same, in the same order, as when evaluated serially. operator() of
+   * \p pOperator must be safe to call on different blobs at the same time,
+   * which the operators of this library are. The blobs that share a
+   * contour, like copies of a Blob or a blob made by Blob::joinBlob() and
+   * the blobs joined into it, and a blob that is several times in the
+   * result, are evaluated one after the other by the same thread, since
+   * evaluating a blob writes its properties and the caches of its contours.
+   */
+  const std::vector<double>& column(BlobOperator* pOperator,
+                                    bool bParallel = false) const;
+
+  /**
+   * @brief Returns the columns computed so far, see column()
+   */
+  inline const FeatureTable& features() const;
+
+  /**
+   * @brief Computes several properties on all the blobs in one pass: every
+   * blob is visited once and all of \p operators are evaluated on it while
+   * its contours are in the cache.
+   * @return a numBlobs() x operators.size() CV_64FC1 matrix, row i holds the
+   * results of blob i in the order of \p operators. Empty if there are no
+   * blobs or no operators.
+   */
+  cv::Mat results(const std::vector<BlobOperator*>& operators) const;
 	
 	//! Calcula un valor sobre un blob de la classe
 	//! Computes some property on one blob of the class
@@ -63,21 +122,81 @@ class BlobResult
               BlobOperator* pOperator,
               FilterCondition condition,
               double lowLimit,
-              double highLimit = 0);
+              double highLimit = 0,
+              bool bParallel = false);
+
+  /**
+   * @brief Returns the indices, in increasing order, of the blobs filter()
+   * would keep with the same arguments, without copying any blob.
+   * The blobs are then reached with blob().
+   */
+  std::vector<std::size_t> filterIndices(FilterAction filterAction,
+                                         BlobOperator* pOperator,
+                                         FilterCondition condition,
+                                         double lowLimit,
+                                         double highLimit = 0,
+                                         bool bParallel = false) const;
+
+  /**
+   * @brief Keeps in \p dst the blobs that pass \p blobFilter
+   * (ACTION_INCLUDE) or that don't (ACTION_EXCLUDE), like chaining filter()
+   * once per condition but in a single pass over the blobs.
+   * The conditions of a blob stop being evaluated once its result is known,
+   * so the expensive operators only run on the blobs that passed the cheap
+   * ones, and no column is built. See BlobFilter.
+   * If \p bParallel is true the blobs are evaluated on several threads, see
+   * result().
+   */
+  void filter(BlobResult& dst,
+              FilterAction filterAction,
+              const BlobFilter& blobFilter,
+              bool bParallel = false);
+
+  /**
+   * @brief Returns the indices, in increasing order, of the blobs
+   * filter(BlobResult&, FilterAction, const BlobFilter&, bool) would keep
+   */
+  std::vector<std::size_t> filterIndices(FilterAction filterAction,
+                                         const BlobFilter& blobFilter,
+                                         bool bParallel = false) const;
 			
 	//! Retorna l'enssim blob segons un determinat criteri
-	//! Sorts the blobs of the class acording to some criteria and returns the n-th blob
+	//! Returns the n-th blob in decreasing order of \p pCriteria, NULL if
+	//! there are less than nBlob + 1 blobs. See topK().
   cv::Ptr<Blob> nthBlob(BlobOperator* pCriteria,
                         std::size_t nBlob) const;
+
+  /**
+   * @brief Returns the \p k blobs with the largest results of \p pCriteria,
+   * or the smallest ones if \p bDescending is false, best first.
+   * Blobs with equal results are ranked by index. Blobs whose result is NaN
+   * are never selected. Fewer than \p k are returned if there aren't enough.
+   *
+   * The blobs are scanned once, keeping the best \p k in a heap, so it is
+   * O(n log k) and only allocates the k results. The column of
+   * \p pCriteria is read if it is known (see column()), otherwise the
+   * criteria is evaluated on each blob without building it.
+   */
+  std::vector<RankedBlob> topK(BlobOperator* pCriteria,
+                               std::size_t k,
+                               bool bDescending = true) const;
 	
 	//! Retorna el blob enssim
 	//! Gets the n-th blob of the class ( without sorting )
   cv::Ptr<Blob> blob(std::size_t i) const;
 	
 	//! Elimina tots els blobs de l'objecte
-	//! Clears all the blobs of the class
+	//! Clears all the blobs of the class, and the arena if one is set
 	void clearBlobs();
 
+  /**
+   * @brief Makes clearBlobs() also clear \p pArena, the arena the blobs of
+   * the frame were allocated from (see BlobArena). NULL by default.
+   * The result doesn't own the arena. Copies of a result don't clear it,
+   * and assigning to a result keeps its own arena.
+   */
+  void setArena(BlobArena* pArena);
+
 	//! Escriu els blobs a un fitxer
 	//! Prints some features of all the blobs in a file
 	void printBlobs(char* pFileName) const;
@@ -88,14 +207,43 @@ class BlobResult
 	//! Gets the total number of blobs
   inline std::size_t numBlobs() const;
 
-	//! Clears a calculated property from blobs
+	//! Clears a calculated property from blobs, \p propertyName being the
+	//! BlobOperator::key() of the operator that computed it
 	void removeProperty(const std::string& propertyName);
 	
  protected:
 
+  //! Sets \p selectedBlobs[i] to 1 if filter() keeps the blob i, to 0
+  //! otherwise
+  void selectBlobs(std::vector<unsigned char>& selectedBlobs,
+                   FilterAction filterAction,
+                   BlobOperator* pOperator,
+                   FilterCondition condition,
+                   double lowLimit,
+                   double highLimit,
+                   bool bParallel) const;
+
+  //! Sets \p selectedBlobs[i] to 1 if filter() keeps the blob i with
+  //! \p blobFilter, to 0 otherwise
+  void selectBlobs(std::vector<unsigned char>& selectedBlobs,
+                   FilterAction filterAction,
+                   const BlobFilter& blobFilter,
+                   bool bParallel) const;
+
+  //! Keeps in \p dst the blobs i, and their columns, where
+  //! \p selectedBlobs[i] isn't 0
+  void keepBlobs(BlobResult& dst,
+                 const std::vector<unsigned char>& selectedBlobs);
+
 	//! Vector amb els blobs
 	//! Vector with all the blobs
 	BlobContainerType mBlobs;
+
+  //! columns of the properties computed on mBlobs, see column()
+  mutable FeatureTable mFeatures;
+
+  //! arena cleared with the blobs, NULL if none
+  BlobArena* mpArena;
 };
 
 inline std::size_t BlobResult::numBlobs() const 
@@ -103,6 +251,11 @@ inline std::size_t BlobResult::numBlobs() const
   return mBlobs.size();
 }
 
+inline const FeatureTable& BlobResult::features() const
+{
+  return mFeatures;
+}
+
 CVBLOBS_END_NAMESPACE
 
 namespace std {
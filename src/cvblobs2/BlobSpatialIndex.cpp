@@ -0,0 +1,348 @@
+#include <cvblobs2/BlobSpatialIndex.h>
+
+#include <limits.h>
+#include <algorithm>
+#include <cmath>
+
+#include <cvblobs2/Blob.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+BlobSpatialIndex::BlobSpatialIndex()
+    : mBoxes(),
+      mCenters(),
+      mOrigin(0, 0),
+      mCellSize(1),
+      mNumColumns(0),
+      mNumRows(0),
+      mCellStarts(),
+      mCellBlobs()
+{}
+
+BlobSpatialIndex::BlobSpatialIndex(const BlobResult& blobs,
+                                   int cellSize /*= 0*/)
+    : mBoxes(),
+      mCenters(),
+      mOrigin(0, 0),
+      mCellSize(1),
+      mNumColumns(0),
+      mNumRows(0),
+      mCellStarts(),
+      mCellBlobs()
+{
+  build(blobs, cellSize);
+}
+
+void BlobSpatialIndex::build(const BlobResult& blobs, int cellSize /*= 0*/)
+{
+  const std::size_t num_blobs = blobs.numBlobs();
+  mBoxes.resize(num_blobs);
+  mCenters.resize(num_blobs);
+  mCellStarts.clear();
+  mCellBlobs.clear();
+  mNumColumns = 0;
+  mNumRows = 0;
+  if (num_blobs == 0)
+  {
+    return;
+  }
+
+  // boxes, their extent and their mean size
+  int min_x = INT_MAX;
+  int min_y = INT_MAX;
+  int max_x = INT_MIN;
+  int max_y = INT_MIN;
+  double sum_sizes = 0.0;
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    cv::Rect box = blobs.blob(i)->boundingBox();
+    box.width = std::max(box.width, 1);
+    box.height = std::max(box.height, 1);
+    mBoxes[i] = box;
+    mCenters[i] = cv::Point2d(box.x + box.width / 2.0,
+                              box.y + box.height / 2.0);
+    min_x = std::min(min_x, box.x);
+    min_y = std::min(min_y, box.y);
+    max_x = std::max(max_x, box.x + box.width);
+    max_y = std::max(max_y, box.y + box.height);
+    sum_sizes += std::max(box.width, box.height);
+  }
+
+  // about one blob per cell, but no smaller than the blobs
+  if (cellSize <= 0)
+  {
+    const double extent_area =
+        static_cast<double>(max_x - min_x) * (max_y - min_y);
+    const double side = std::max(sum_sizes / num_blobs,
+                                 std::sqrt(extent_area / num_blobs));
+    cellSize = static_cast<int>(std::ceil(side));
+  }
+  mCellSize = std::max(cellSize, 1);
+  mOrigin = cv::Point(min_x, min_y);
+  mNumColumns = (max_x - min_x + mCellSize - 1) / mCellSize;
+  mNumRows = (max_y - min_y + mCellSize - 1) / mCellSize;
+
+  // count the blobs of every cell, then turn the counts into the starts
+  const int num_cells = mNumColumns * mNumRows;
+  mCellStarts.assign(num_cells + 1, 0);
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    const cv::Rect& box = mBoxes[i];
+    const int first_column = (box.x - mOrigin.x) / mCellSize;
+    const int last_column = (box.x + box.width - 1 - mOrigin.x) / mCellSize;
+    const int first_row = (box.y - mOrigin.y) / mCellSize;
+    const int last_row = (box.y + box.height - 1 - mOrigin.y) / mCellSize;
+    for (int r = first_row; r <= last_row; ++r)
+    {
+      for (int c = first_column; c <= last_column; ++c)
+      {
+        ++mCellStarts[r * mNumColumns + c + 1];
+      }
+    }
+  }
+  for (int c = 0; c < num_cells; ++c)
+  {
+    mCellStarts[c + 1] += mCellStarts[c];
+  }
+
+  // fill the cells, in increasing order of blob
+  std::vector<int> cell_ends(mCellStarts.begin(), mCellStarts.end() - 1);
+  mCellBlobs.resize(mCellStarts.back());
+  for (std::size_t i = 0; i < num_blobs; ++i)
+  {
+    const cv::Rect& box = mBoxes[i];
+    const int first_column = (box.x - mOrigin.x) / mCellSize;
+    const int last_column = (box.x + box.width - 1 - mOrigin.x) / mCellSize;
+    const int first_row = (box.y - mOrigin.y) / mCellSize;
+    const int last_row = (box.y + box.height - 1 - mOrigin.y) / mCellSize;
+    for (int r = first_row; r <= last_row; ++r)
+    {
+      for (int c = first_column; c <= last_column; ++c)
+      {
+        mCellBlobs[cell_ends[r * mNumColumns + c]++] = static_cast<int>(i);
+      }
+    }
+  }
+}
+
+void BlobSpatialIndex::intersecting(const cv::Rect& rect,
+                                    std::vector<std::size_t>& indices) const
+{
+  indices.clear();
+  if (mNumColumns == 0 || rect.width <= 0 || rect.height <= 0)
+  {
+    return;
+  }
+
+  const int first_column = column(rect.x);
+  const int last_column = column(rect.x + rect.width - 1);
+  const int first_row = row(rect.y);
+  const int last_row = row(rect.y + rect.height - 1);
+  for (int r = first_row; r <= last_row; ++r)
+  {
+    for (int c = first_column; c <= last_column; ++c)
+    {
+      const int cell = r * mNumColumns + c;
+      for (int k = mCellStarts[cell]; k < mCellStarts[cell + 1]; ++k)
+      {
+        const int i = mCellBlobs[k];
+        const cv::Rect intersection = mBoxes[i] & rect;
+        // a blob is in all the cells of the intersection, only report it
+        // from the one of its top-left corner
+        if (intersection.width > 0 &&
+            intersection.height > 0 &&
+            column(intersection.x) == c &&
+            row(intersection.y) == r)
+        {
+          indices.push_back(i);
+        }
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+}
+
+void BlobSpatialIndex::withinRadius(const cv::Point2d& point,
+                                    double radius,
+                                    std::vector<std::size_t>& indices) const
+{
+  indices.clear();
+  if (mNumColumns == 0 || radius < 0.0)
+  {
+    return;
+  }
+
+  const double radius_squared = radius * radius;
+  const int first_column = column(point.x - radius);
+  const int last_column = column(point.x + radius);
+  const int first_row = row(point.y - radius);
+  const int last_row = row(point.y + radius);
+  for (int r = first_row; r <= last_row; ++r)
+  {
+    for (int c = first_column; c <= last_column; ++c)
+    {
+      const int cell = r * mNumColumns + c;
+      for (int k = mCellStarts[cell]; k < mCellStarts[cell + 1]; ++k)
+      {
+        const int i = mCellBlobs[k];
+        const cv::Point2d& center = mCenters[i];
+        const double dx = center.x - point.x;
+        const double dy = center.y - point.y;
+        // a blob is in the cell of its center, only report it from there
+        if (dx * dx + dy * dy <= radius_squared &&
+            column(center.x) == c &&
+            row(center.y) == r)
+        {
+          indices.push_back(i);
+        }
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+}
+
+void BlobSpatialIndex::nearest(const cv::Point2d& point,
+                               std::size_t k,
+                               std::vector<std::size_t>& indices,
+                               std::vector<double>& distances) const
+{
+  indices.clear();
+  distances.clear();
+  k = std::min(k, mBoxes.size());
+  if (k == 0)
+  {
+    return;
+  }
+
+  // heap of the k nearest blobs so far, the farthest on top. Rings of cells
+  // around the cell of point are searched until the nearest cell not
+  // searched yet is farther than all of them.
+  std::vector<DistanceIndex> best;
+  best.reserve(k);
+  const int center_column = column(point.x);
+  const int center_row = row(point.y);
+  const int max_ring = std::max(mNumColumns, mNumRows);
+  for (int ring = 0; ring <= max_ring; ++ring)
+  {
+    const int first_row = center_row - ring;
+    const int last_row = center_row + ring;
+    const int first_column = center_column - ring;
+    const int last_column = center_column + ring;
+    for (int r = std::max(first_row, 0);
+         r <= std::min(last_row, mNumRows - 1);
+         ++r)
+    {
+      // the whole first and last rows of the ring, the ends of the others
+      if (r == first_row || r == last_row)
+      {
+        for (int c = std::max(first_column, 0);
+             c <= std::min(last_column, mNumColumns - 1);
+             ++c)
+        {
+          nearestInCell(c, r, point, k, best);
+        }
+      }
+      else
+      {
+        if (first_column >= 0)
+        {
+          nearestInCell(first_column, r, point, k, best);
+        }
+        if (last_column < mNumColumns)
+        {
+          nearestInCell(last_column, r, point, k, best);
+        }
+      }
+    }
+
+    // distance from point to the cells outside the rings searched so far
+    const double left = mOrigin.x +
+        static_cast<double>(center_column - ring) * mCellSize;
+    const double right = mOrigin.x +
+        static_cast<double>(center_column + ring + 1) * mCellSize;
+    const double top = mOrigin.y +
+        static_cast<double>(center_row - ring) * mCellSize;
+    const double bottom = mOrigin.y +
+        static_cast<double>(center_row + ring + 1) * mCellSize;
+    const double unsearched_distance = std::min(std::min(point.x - left,
+                                                         right - point.x),
+                                                std::min(point.y - top,
+                                                         bottom - point.y));
+    if (best.size() == k && best.front().first < unsearched_distance)
+    {
+      break;
+    }
+  }
+  std::sort_heap(best.begin(), best.end());
+
+  indices.resize(best.size());
+  distances.resize(best.size());
+  for (std::size_t j = 0; j < best.size(); ++j)
+  {
+    indices[j] = best[j].second;
+    distances[j] = best[j].first;
+  }
+}
+
+void BlobSpatialIndex::nearestInCell(int c,
+                                     int r,
+                                     const cv::Point2d& point,
+                                     std::size_t k,
+                                     std::vector<DistanceIndex>& best) const
+{
+  const int cell = r * mNumColumns + c;
+  for (int j = mCellStarts[cell]; j < mCellStarts[cell + 1]; ++j)
+  {
+    const int i = mCellBlobs[j];
+    const cv::Point2d& center = mCenters[i];
+    // a blob is in the cell of its center, only consider it from there
+    if (column(center.x) != c || row(center.y) != r)
+    {
+      continue;
+    }
+    const double dx = center.x - point.x;
+    const double dy = center.y - point.y;
+    const DistanceIndex candidate(std::sqrt(dx * dx + dy * dy), i);
+    if (best.size() < k)
+    {
+      best.push_back(candidate);
+      std::push_heap(best.begin(), best.end());
+    }
+    else if (candidate < best.front())
+    {
+      std::pop_heap(best.begin(), best.end());
+      best.back() = candidate;
+      std::push_heap(best.begin(), best.end());
+    }
+  }
+}
+
+int BlobSpatialIndex::column(double x) const
+{
+  const double c = std::floor((x - mOrigin.x) / mCellSize);
+  if (c < 0.0)
+  {
+    return 0;
+  }
+  if (c >= mNumColumns)
+  {
+    return mNumColumns - 1;
+  }
+  return static_cast<int>(c);
+}
+
+int BlobSpatialIndex::row(double y) const
+{
+  const double r = std::floor((y - mOrigin.y) / mCellSize);
+  if (r < 0.0)
+  {
+    return 0;
+  }
+  if (r >= mNumRows)
+  {
+    return mNumRows - 1;
+  }
+  return static_cast<int>(r);
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,162 @@
+/**
+ * @brief Uniform grid over the bounding boxes of blobs.
+ */
+#ifndef _CVBLOBS2_BLOBSPATIALINDEX_H_
+#define _CVBLOBS2_BLOBSPATIALINDEX_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/BlobResult.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class BlobSpatialIndex
+ * @brief Finds the blobs of a BlobResult near a point or a region without
+ * visiting all of them.
+ *
+ * The plane is divided in square cells and every blob is listed in the
+ * cells its Blob::boundingBox() covers. The lists are packed one after the
+ * other in a single array (mCellBlobs), mCellStarts[c] being where the list
+ * of the cell c starts, so building the index is two passes over the blobs
+ * and rebuilding it for the next frame reuses the memory of the previous one.
+ *
+ * Queries return the indices of the blobs in the BlobResult the index was
+ * built from, which must not change until the next build(); the blobs are
+ * reached with BlobResult::blob(). The index only keeps the boxes of the
+ * blobs, not the blobs, so it doesn't keep the blobs of a BlobArena alive
+ * past the frame they were labeled in. Distances are
+ * measured from the center of the bounding box, like
+ * BlobGetDistanceFromPoint. A bounding box without width or height counts
+ * as one pixel wide or high.
+ */
+class BlobSpatialIndex
+{
+ public:
+
+  BlobSpatialIndex();
+
+  /**
+   * @brief Builds the index of \p blobs, see build()
+   */
+  explicit BlobSpatialIndex(const BlobResult& blobs, int cellSize = 0);
+
+  /**
+   * @brief Indexes the blobs of \p blobs, replacing the previous ones.
+   * @param blobs the blobs to index
+   * @param cellSize side of the cells in pixels. If 0 it is chosen so that
+   * a cell holds about one blob and a blob covers few cells.
+   */
+  void build(const BlobResult& blobs, int cellSize = 0);
+
+  /**
+   * @brief Sets \p indices to the blobs whose bounding box intersects
+   * \p rect, in increasing order
+   */
+  void intersecting(const cv::Rect& rect,
+                    std::vector<std::size_t>& indices) const;
+
+  /**
+   * @brief Sets \p indices to the blobs whose center is at most \p radius
+   * away from \p point, in increasing order
+   */
+  void withinRadius(const cv::Point2d& point,
+                    double radius,
+                    std::vector<std::size_t>& indices) const;
+
+  /**
+   * @brief Sets \p indices to the \p k blobs whose centers are the closest
+   * to \p point, closest first, and \p distances to the distances of their
+   * centers. Blobs at the same distance are ranked by index.
+   */
+  void nearest(const cv::Point2d& point,
+               std::size_t k,
+               std::vector<std::size_t>& indices,
+               std::vector<double>& distances) const;
+
+  /**
+   * @brief Returns the number of indexed blobs
+   */
+  inline std::size_t numBlobs() const;
+
+  /**
+   * @brief Returns the side of the cells in pixels
+   */
+  inline int cellSize() const;
+
+  /**
+   * @brief Returns the bounding box of the blob \p i
+   */
+  inline const cv::Rect& boundingBox(std::size_t i) const;
+
+  /**
+   * @brief Returns the center of the bounding box of the blob \p i
+   */
+  inline const cv::Point2d& center(std::size_t i) const;
+
+ private:
+
+  //! (distance, index) of a blob found by nearest()
+  typedef std::pair<double, std::size_t> DistanceIndex;
+
+  //! Adds the blobs whose center is in the cell (\p c, \p r) to \p best,
+  //! the heap of the \p k blobs nearest to \p point found so far
+  void nearestInCell(int c,
+                     int r,
+                     const cv::Point2d& point,
+                     std::size_t k,
+                     std::vector<DistanceIndex>& best) const;
+
+  //! column of the cell containing \p x, clamped to the grid
+  int column(double x) const;
+
+  //! row of the cell containing \p y, clamped to the grid
+  int row(double y) const;
+
+  //! bounding boxes of the blobs
+  std::vector<cv::Rect> mBoxes;
+  //! centers of the bounding boxes
+  std::vector<cv::Point2d> mCenters;
+
+  //! top-left corner of the grid
+  cv::Point mOrigin;
+  //! side of the cells in pixels
+  int mCellSize;
+  //! size of the grid in cells
+  int mNumColumns;
+  int mNumRows;
+
+  //! the blobs of the cell c are mCellBlobs[mCellStarts[c]] up to
+  //! mCellBlobs[mCellStarts[c + 1]], cells are numbered row by row
+  std::vector<int> mCellStarts;
+  std::vector<int> mCellBlobs;
+};
+
+inline std::size_t BlobSpatialIndex::numBlobs() const
+{
+  return mBoxes.size();
+}
+
+inline int BlobSpatialIndex::cellSize() const
+{
+  return mCellSize;
+}
+
+inline const cv::Rect& BlobSpatialIndex::boundingBox(std::size_t i) const
+{
+  return mBoxes[i];
+}
+
+inline const cv::Point2d& BlobSpatialIndex::center(std::size_t i) const
+{
+  return mCenters[i];
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBSPATIALINDEX_H_
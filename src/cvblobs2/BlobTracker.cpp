@@ -0,0 +1,361 @@
+#include <cvblobs2/BlobTracker.h>
+
+#include <algorithm>
+
+#include <cvblobs2/BlobResult.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! no track or blob matched
+const std::size_t NO_MATCH = static_cast<std::size_t>(-1);
+
+} // end anonymous namespace
+
+///////////
+// Track //
+///////////
+Track::Track()
+    : mId(0),
+      mBlobIndex(0),
+      mFirstFrame(0),
+      mSamples(),
+      mFirstSample(0),
+      mSampleCapacity(1)
+{}
+
+Track::Track(unsigned int id, std::size_t historyCapacity)
+    : mId(id),
+      mBlobIndex(0),
+      mFirstFrame(0),
+      mSamples(),
+      mFirstSample(0),
+      mSampleCapacity(std::max<std::size_t>(historyCapacity, 1))
+{}
+
+void Track::swap(Track& other)
+{
+  std::swap(mId, other.mId);
+  std::swap(mBlobIndex, other.mBlobIndex);
+  std::swap(mFirstFrame, other.mFirstFrame);
+  mSamples.swap(other.mSamples);
+  std::swap(mFirstSample, other.mFirstSample);
+  std::swap(mSampleCapacity, other.mSampleCapacity);
+}
+
+void Track::update(std::size_t blobIndex, const TrackSample& trackSample)
+{
+  mBlobIndex = blobIndex;
+  if (mSamples.empty())
+  {
+    mFirstFrame = trackSample.frame;
+    mSamples.reserve(mSampleCapacity);
+  }
+
+  // once full the oldest sample is overwritten
+  if (mSamples.size() < mSampleCapacity)
+  {
+    mSamples.push_back(trackSample);
+  }
+  else
+  {
+    mSamples[mFirstSample] = trackSample;
+    mFirstSample = (mFirstSample + 1) % mSampleCapacity;
+  }
+}
+
+/////////////////
+// BlobTracker //
+/////////////////
+BlobTracker::BlobTracker(double minOverlap /*= 0.1*/,
+                         double maxCenterDistance /*= 0.0*/,
+                         std::size_t historyLength /*= 32*/)
+    : mMinOverlap(minOverlap),
+      mMaxCenterDistance(maxCenterDistance),
+      mHistoryLength(historyLength),
+      mFrame(0),
+      mNextTrackId(1),
+      mTracks(),
+      mEvents(),
+      mBlobTrackIds(),
+      mIndex(),
+      mCandidates(),
+      mTrackBlobs(),
+      mBlobTracks(),
+      mSplitFrom(),
+      mMergedInto(),
+      mNeighbours()
+{}
+
+void BlobTracker::update(const BlobResult& blobs)
+{
+  ++mFrame;
+  mEvents.clear();
+  mIndex.build(blobs);
+  findCandidates();
+  matchTracks();
+  updateTracks();
+}
+
+void BlobTracker::clear()
+{
+  mFrame = 0;
+  mTracks.clear();
+  mEvents.clear();
+  mBlobTrackIds.clear();
+}
+
+bool BlobTracker::GreaterOverlap::operator()(const Candidate& lhs,
+                                             const Candidate& rhs) const
+{
+  if (lhs.overlap != rhs.overlap)
+  {
+    return lhs.overlap > rhs.overlap;
+  }
+  if (lhs.track != rhs.track)
+  {
+    return lhs.track < rhs.track;
+  }
+  return lhs.blob < rhs.blob;
+}
+
+bool BlobTracker::GreaterCover::operator()(const Candidate& lhs,
+                                           const Candidate& rhs) const
+{
+  if (lhs.cover != rhs.cover)
+  {
+    return lhs.cover > rhs.cover;
+  }
+  if (lhs.track != rhs.track)
+  {
+    return lhs.track < rhs.track;
+  }
+  return lhs.blob < rhs.blob;
+}
+
+void BlobTracker::findCandidates()
+{
+  mCandidates.clear();
+  for (std::size_t t = 0; t < mTracks.size(); ++t)
+  {
+    const cv::Rect& track_box = mTracks[t].lastSample().boundingBox;
+    mIndex.intersecting(track_box, mNeighbours);
+    for (std::size_t k = 0; k < mNeighbours.size(); ++k)
+    {
+      const std::size_t b = mNeighbours[k];
+      const cv::Rect& blob_box = mIndex.boundingBox(b);
+      const double intersection = (track_box & blob_box).area();
+      const double track_area = track_box.area();
+      const double blob_area = blob_box.area();
+
+      Candidate candidate;
+      candidate.track = t;
+      candidate.blob = b;
+      candidate.overlap = intersection /
+                          (track_area + blob_area - intersection);
+      candidate.cover = intersection / std::min(track_area, blob_area);
+      if (candidate.cover >= mMinOverlap)
+      {
+        mCandidates.push_back(candidate);
+      }
+    }
+  }
+}
+
+void BlobTracker::matchTracks()
+{
+  mTrackBlobs.assign(mTracks.size(), NO_MATCH);
+  mBlobTracks.assign(mIndex.numBlobs(), NO_MATCH);
+
+  // best overlaps first
+  std::sort(mCandidates.begin(), mCandidates.end(), GreaterOverlap());
+  for (std::size_t k = 0; k < mCandidates.size(); ++k)
+  {
+    const Candidate& candidate = mCandidates[k];
+    if (candidate.overlap < mMinOverlap)
+    {
+      break;
+    }
+    if (mTrackBlobs[candidate.track] == NO_MATCH &&
+        mBlobTracks[candidate.blob] == NO_MATCH)
+    {
+      mTrackBlobs[candidate.track] = candidate.blob;
+      mBlobTracks[candidate.blob] = candidate.track;
+    }
+  }
+
+  if (mMaxCenterDistance <= 0.0)
+  {
+    return;
+  }
+
+  // the nearest free blob of the tracks that don't overlap any
+  for (std::size_t t = 0; t < mTracks.size(); ++t)
+  {
+    if (mTrackBlobs[t] != NO_MATCH)
+    {
+      continue;
+    }
+    const cv::Point2d& track_center = mTracks[t].lastSample().center;
+    mIndex.withinRadius(track_center, mMaxCenterDistance, mNeighbours);
+    std::size_t nearest_blob = NO_MATCH;
+    double nearest_distance = 0.0;
+    for (std::size_t k = 0; k < mNeighbours.size(); ++k)
+    {
+      const std::size_t b = mNeighbours[k];
+      if (mBlobTracks[b] != NO_MATCH)
+      {
+        continue;
+      }
+      const cv::Point2d offset = mIndex.center(b) - track_center;
+      const double distance = offset.dot(offset);
+      if (nearest_blob == NO_MATCH || distance < nearest_distance)
+      {
+        nearest_blob = b;
+        nearest_distance = distance;
+      }
+    }
+    if (nearest_blob != NO_MATCH)
+    {
+      mTrackBlobs[t] = nearest_blob;
+      mBlobTracks[nearest_blob] = t;
+    }
+  }
+}
+
+void BlobTracker::updateTracks()
+{
+  const std::size_t num_tracks = mTracks.size();
+  const std::size_t num_blobs = mIndex.numBlobs();
+
+  // the matched track a free blob covers the most, and the matched blob a
+  // free track covers the most
+  mSplitFrom.assign(num_blobs, NO_MATCH);
+  mMergedInto.assign(num_tracks, NO_MATCH);
+  std::sort(mCandidates.begin(), mCandidates.end(), GreaterCover());
+  for (std::size_t k = 0; k < mCandidates.size(); ++k)
+  {
+    const Candidate& candidate = mCandidates[k];
+    const bool b_track_matched = (mTrackBlobs[candidate.track] != NO_MATCH);
+    const bool b_blob_matched = (mBlobTracks[candidate.blob] != NO_MATCH);
+    if (b_track_matched &&
+        !b_blob_matched &&
+        mSplitFrom[candidate.blob] == NO_MATCH)
+    {
+      mSplitFrom[candidate.blob] = candidate.track;
+    }
+    else if (!b_track_matched &&
+             b_blob_matched &&
+             mMergedInto[candidate.track] == NO_MATCH)
+    {
+      mMergedInto[candidate.track] = candidate.blob;
+    }
+  }
+
+  // tracks that end
+  for (std::size_t t = 0; t < num_tracks; ++t)
+  {
+    if (mTrackBlobs[t] != NO_MATCH)
+    {
+      continue;
+    }
+    if (mMergedInto[t] != NO_MATCH)
+    {
+      const std::size_t into_track = mBlobTracks[mMergedInto[t]];
+      addEvent(TRACK_MERGE, mTracks[t].id(), mTracks[into_track].id());
+    }
+    else
+    {
+      addEvent(TRACK_DEATH, mTracks[t].id(), 0);
+    }
+  }
+
+  // tracks that start, numbered in the order of their blobs
+  std::size_t num_new_tracks = 0;
+  for (std::size_t b = 0; b < num_blobs; ++b)
+  {
+    if (mBlobTracks[b] != NO_MATCH)
+    {
+      continue;
+    }
+    const unsigned int track_id =
+        mNextTrackId + static_cast<unsigned int>(num_new_tracks);
+    ++num_new_tracks;
+    if (mSplitFrom[b] != NO_MATCH)
+    {
+      addEvent(TRACK_SPLIT, track_id, mTracks[mSplitFrom[b]].id());
+    }
+    else
+    {
+      addEvent(TRACK_BIRTH, track_id, 0);
+    }
+  }
+
+  // keep the matched tracks in order, swapping to not copy their samples
+  std::size_t num_kept = 0;
+  for (std::size_t t = 0; t < num_tracks; ++t)
+  {
+    if (mTrackBlobs[t] == NO_MATCH)
+    {
+      continue;
+    }
+    if (num_kept != t)
+    {
+      mTracks[num_kept].swap(mTracks[t]);
+    }
+    mTrackBlobs[num_kept] = mTrackBlobs[t];
+    ++num_kept;
+  }
+
+  // growing mTracks would copy the samples of every track
+  const std::size_t num_all_tracks = num_kept + num_new_tracks;
+  if (num_all_tracks > mTracks.capacity())
+  {
+    std::vector<Track> grown_tracks;
+    grown_tracks.reserve(std::max(num_all_tracks, 2 * mTracks.capacity()));
+    grown_tracks.resize(num_kept);
+    for (std::size_t t = 0; t < num_kept; ++t)
+    {
+      grown_tracks[t].swap(mTracks[t]);
+    }
+    mTracks.swap(grown_tracks);
+  }
+  mTracks.resize(num_kept);
+  mTrackBlobs.resize(num_kept);
+
+  for (std::size_t b = 0; b < num_blobs; ++b)
+  {
+    if (mBlobTracks[b] == NO_MATCH)
+    {
+      mTracks.push_back(Track(mNextTrackId++, mHistoryLength));
+      mTrackBlobs.push_back(b);
+    }
+  }
+
+  // samples of this frame
+  mBlobTrackIds.assign(num_blobs, 0);
+  for (std::size_t t = 0; t < mTracks.size(); ++t)
+  {
+    const std::size_t b = mTrackBlobs[t];
+    TrackSample track_sample;
+    track_sample.frame = mFrame;
+    track_sample.boundingBox = mIndex.boundingBox(b);
+    track_sample.center = mIndex.center(b);
+    mTracks[t].update(b, track_sample);
+    mBlobTrackIds[b] = mTracks[t].id();
+  }
+}
+
+void BlobTracker::addEvent(TrackEventType type,
+                           unsigned int trackId,
+                           unsigned int otherTrackId)
+{
+  TrackEvent event;
+  event.type = type;
+  event.trackId = trackId;
+  event.otherTrackId = otherTrackId;
+  mEvents.push_back(event);
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,308 @@
+/**
+ * @brief Association of the blobs of successive frames into tracks.
+ */
+#ifndef _CVBLOBS2_BLOBTRACKER_H_
+#define _CVBLOBS2_BLOBTRACKER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/BlobSpatialIndex.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Position of a track in one frame
+ */
+struct TrackSample
+{
+  //! number of the frame, see BlobTracker::frame()
+  std::size_t frame;
+  //! bounding box of the blob of the track in the frame
+  cv::Rect boundingBox;
+  //! center of the bounding box
+  cv::Point2d center;
+};
+
+/**
+ * @brief Something that happened to a track in the last frame, see
+ * BlobTracker::events()
+ */
+struct TrackEvent
+{
+  TrackEventType type;
+  //! the track born, dead, split off or merged
+  unsigned int trackId;
+  //! the track split from (TRACK_SPLIT) or merged into (TRACK_MERGE),
+  //! 0 otherwise
+  unsigned int otherTrackId;
+};
+
+/**
+ * @class Track
+ * @brief A blob followed over several frames by a BlobTracker.
+ *
+ * The track keeps its last samples in a ring buffer of fixed capacity, so a
+ * long lived track uses no more memory than a new one.
+ */
+class Track
+{
+  friend class BlobTracker;
+
+ public:
+
+  Track();
+
+  /**
+   * @brief Track \p id keeping its last \p historyCapacity samples
+   */
+  Track(unsigned int id, std::size_t historyCapacity);
+
+  /**
+   * @brief Returns the id of the track, unique for a BlobTracker and never 0
+   */
+  inline unsigned int id() const;
+
+  /**
+   * @brief Returns the index of the blob of the track in the last BlobResult
+   * given to BlobTracker::update(), see BlobResult::blob()
+   */
+  inline std::size_t blobIndex() const;
+
+  /**
+   * @brief Returns the frame the track started in
+   */
+  inline std::size_t firstFrame() const;
+
+  /**
+   * @brief Returns the number of samples kept, at most the capacity given
+   * to the constructor
+   */
+  inline std::size_t numSamples() const;
+
+  /**
+   * @brief Returns the sample \p i, 0 being the oldest one kept
+   * @pre \p i < numSamples()
+   */
+  inline const TrackSample& sample(std::size_t i) const;
+
+  /**
+   * @brief Returns the sample of the last frame
+   * @pre numSamples() > 0
+   */
+  inline const TrackSample& lastSample() const;
+
+  /**
+   * @brief Swaps this track with \p other without copying their samples
+   */
+  void swap(Track& other);
+
+ private:
+
+  //! Makes the blob \p blobIndex the blob of the track in the frame of
+  //! \p trackSample
+  void update(std::size_t blobIndex, const TrackSample& trackSample);
+
+  unsigned int mId;
+  std::size_t mBlobIndex;
+  std::size_t mFirstFrame;
+
+  //! ring buffer of the last samples, the oldest at mFirstSample once full
+  std::vector<TrackSample> mSamples;
+  std::size_t mFirstSample;
+  std::size_t mSampleCapacity;
+};
+
+/**
+ * @class BlobTracker
+ * @brief Follows blobs from frame to frame by the overlap of their bounding
+ * boxes.
+ *
+ * Each call to update() takes the blobs of the next frame and matches them
+ * with the tracks of the previous one:
+ * - a BlobSpatialIndex over the new blobs finds the blobs that overlap the
+ *   last bounding box of every track, so the cost grows with the number of
+ *   overlapping pairs rather than tracks x blobs;
+ * - the pairs whose intersection over union is at least the minimum overlap
+ *   are matched greedily, best first, one blob per track;
+ * - if a maximum center distance is set, the tracks left are matched with
+ *   the nearest blob left whose center is close enough;
+ * - a blob left that covers enough of a matched track (intersection over
+ *   the smaller of the two boxes) split from it, and starts a new track
+ *   (TRACK_SPLIT); any other blob left starts a new track (TRACK_BIRTH);
+ * - a track left that covers enough of a matched blob merged into the track
+ *   of that blob and ends (TRACK_MERGE); any other track left ends
+ *   (TRACK_DEATH).
+ *
+ * Only the boxes of the blobs are kept from one frame to the next, never
+ * the blobs, so the blobs of a BlobArena can be tracked and the arena
+ * cleared after every update().
+ */
+class BlobTracker
+{
+ public:
+
+  /**
+   * @brief Tracker matching blobs with an overlap of at least
+   * \p minOverlap, or centers at most \p maxCenterDistance away if it isn't
+   * 0, and keeping the last \p historyLength samples of every track
+   */
+  explicit BlobTracker(double minOverlap = 0.1,
+                       double maxCenterDistance = 0.0,
+                       std::size_t historyLength = 32);
+
+  /**
+   * @brief Matches the blobs of the next frame with the tracks, see the
+   * class description. tracks(), events() and trackId() then describe this
+   * frame.
+   */
+  void update(const BlobResult& blobs);
+
+  /**
+   * @brief Ends all of the tracks and restarts the frame count, without
+   * reporting any event
+   */
+  void clear();
+
+  /**
+   * @brief Returns the number of frames given to update()
+   */
+  inline std::size_t frame() const;
+
+  /**
+   * @brief Returns the tracks of the last frame, one per blob
+   */
+  inline const std::vector<Track>& tracks() const;
+
+  /**
+   * @brief Returns the births, deaths, splits and merges of the last frame
+   */
+  inline const std::vector<TrackEvent>& events() const;
+
+  /**
+   * @brief Returns the id of the track of the blob \p blobIndex of the last
+   * frame
+   */
+  inline unsigned int trackId(std::size_t blobIndex) const;
+
+ private:
+
+  //! A track and a blob whose bounding boxes overlap
+  struct Candidate
+  {
+    std::size_t track;
+    std::size_t blob;
+    //! intersection over union
+    double overlap;
+    //! intersection over the area of the smaller box
+    double cover;
+  };
+
+  //! Orders the candidates by decreasing overlap
+  struct GreaterOverlap
+  {
+    bool operator()(const Candidate& lhs, const Candidate& rhs) const;
+  };
+
+  //! Orders the candidates by decreasing cover
+  struct GreaterCover
+  {
+    bool operator()(const Candidate& lhs, const Candidate& rhs) const;
+  };
+
+  //! Fills mCandidates with the pairs covering at least mMinOverlap
+  void findCandidates();
+
+  //! Matches the tracks with the blobs, see the class description
+  void matchTracks();
+
+  //! Adds the events of the unmatched blobs and tracks and replaces the
+  //! tracks by the ones of the new blobs
+  void updateTracks();
+
+  //! Records an event
+  void addEvent(TrackEventType type,
+                unsigned int trackId,
+                unsigned int otherTrackId);
+
+  double mMinOverlap;
+  double mMaxCenterDistance;
+  std::size_t mHistoryLength;
+
+  std::size_t mFrame;
+  unsigned int mNextTrackId;
+  std::vector<Track> mTracks;
+  std::vector<TrackEvent> mEvents;
+  //! id of the track of every blob of the last frame
+  std::vector<unsigned int> mBlobTrackIds;
+
+  //! state of the frame being matched, kept to reuse its memory
+  BlobSpatialIndex mIndex;
+  std::vector<Candidate> mCandidates;
+  //! blob matched with every track, NO_MATCH if none
+  std::vector<std::size_t> mTrackBlobs;
+  //! track matched with every blob, NO_MATCH if none
+  std::vector<std::size_t> mBlobTracks;
+  //! matched track every free blob split from, NO_MATCH if none
+  std::vector<std::size_t> mSplitFrom;
+  //! matched blob every free track merged into, NO_MATCH if none
+  std::vector<std::size_t> mMergedInto;
+  std::vector<std::size_t> mNeighbours;
+};
+
+inline unsigned int Track::id() const
+{
+  return mId;
+}
+
+inline std::size_t Track::blobIndex() const
+{
+  return mBlobIndex;
+}
+
+inline std::size_t Track::firstFrame() const
+{
+  return mFirstFrame;
+}
+
+inline std::size_t Track::numSamples() const
+{
+  return mSamples.size();
+}
+
+inline const TrackSample& Track::sample(std::size_t i) const
+{
+  return mSamples[(mFirstSample + i) % mSamples.size()];
+}
+
+inline const TrackSample& Track::lastSample() const
+{
+  return sample(mSamples.size() - 1);
+}
+
+inline std::size_t BlobTracker::frame() const
+{
+  return mFrame;
+}
+
+inline const std::vector<Track>& BlobTracker::tracks() const
+{
+  return mTracks;
+}
+
+inline const std::vector<TrackEvent>& BlobTracker::events() const
+{
+  return mEvents;
+}
+
+inline unsigned int BlobTracker::trackId(std::size_t blobIndex) const
+{
+  return mBlobTrackIds[blobIndex];
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_BLOBTRACKER_H_
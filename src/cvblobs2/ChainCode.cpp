@@ -121,4 +121,17 @@ ChainCode point2ChainCode(const cv::Point& point)
   return CHAIN_CODE_INVALID;
 }
 
+void chainCodeOffsets(int rowStep,
+                      int offsets[CHAIN_CODE_MAX])
+{
+  offsets[CHAIN_CODE_RIGHT]      = 1;
+  offsets[CHAIN_CODE_UP_RIGHT]   = 1 - rowStep;
+  offsets[CHAIN_CODE_UP]         = -rowStep;
+  offsets[CHAIN_CODE_UP_LEFT]    = -1 - rowStep;
+  offsets[CHAIN_CODE_LEFT]       = -1;
+  offsets[CHAIN_CODE_DOWN_LEFT]  = -1 + rowStep;
+  offsets[CHAIN_CODE_DOWN]       = rowStep;
+  offsets[CHAIN_CODE_DOWN_RIGHT] = 1 + rowStep;
+}
+
 CVBLOBS_END_NAMESPACE
@@ -90,6 +90,15 @@ cv::Point chainCodePoint(const ChainCode& movement);
  */
 ChainCode point2ChainCode(const cv::Point& point);
 
+/** 
+ * @brief Fills \p offsets with the offset, in elements, of the neighbour
+ * reached by every chain code in a row major buffer.
+ * @param rowStep number of elements in a row of the buffer
+ * @param offsets indexed by ChainCode
+ */
+void chainCodeOffsets(int rowStep,
+                      int offsets[CHAIN_CODE_MAX]);
+
 CVBLOBS_END_NAMESPACE
 
 #endif // _CVBLOBS2_CHAINCODE_H_
@@ -0,0 +1,57 @@
+#include <cvblobs2/ChainCodeContainer.h>
+
+#include <algorithm>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+const std::size_t ChainCodeContainer::CODES_PER_WORD;
+const unsigned int ChainCodeContainer::BITS_PER_CODE;
+
+ChainCodeContainer::ChainCodeContainer()
+    : mWords(),
+      mSize(0)
+{}
+
+void ChainCodeContainer::append(const ChainCodeContainer& other)
+{
+  if (&other == this)
+  {
+    ChainCodeContainer copy(other);
+    append(copy);
+    return;
+  }
+
+  if (mSize % CODES_PER_WORD == 0)
+  {
+    // the last word is full, the words of other can be copied as they are
+    mWords.insert(mWords.end(), other.mWords.begin(), other.mWords.end());
+    mSize += other.mSize;
+    return;
+  }
+
+  reserve(mSize + other.mSize);
+  const_iterator end_iter = other.end();
+  for (const_iterator iter = other.begin(); iter != end_iter; ++iter)
+  {
+    push_back(*iter);
+  }
+}
+
+void ChainCodeContainer::reserve(std::size_t numCodes)
+{
+  mWords.reserve((numCodes + CODES_PER_WORD - 1) / CODES_PER_WORD);
+}
+
+void ChainCodeContainer::clear()
+{
+  mWords.clear();
+  mSize = 0;
+}
+
+void ChainCodeContainer::swap(ChainCodeContainer& other)
+{
+  mWords.swap(other.mWords);
+  std::swap(mSize, other.mSize);
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,200 @@
+/**
+ * @brief Compact storage for the chain codes of a contour.
+ */
+#ifndef _CVBLOBS2_CHAINCODECONTAINER_H_
+#define _CVBLOBS2_CHAINCODECONTAINER_H_
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <cvblobs2/ChainCode.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class ChainCodeContainer
+ * @brief Sequence of chain codes packed 3 bits each, 10 codes per 32 bit word.
+ *
+ * A chain code only needs 3 bits, so the codes are packed in a contiguous
+ * std::vector of words instead of one heap node per code. The words grow
+ * geometrically like any std::vector, so push_back() doesn't allocate for
+ * every code and a contour takes 0.4 bytes per code.
+ *
+ * The codes are read back with a forward const_iterator whose operator*
+ * returns the ChainCode by value.
+ */
+class ChainCodeContainer
+{
+ public:
+
+  //! number of codes stored in a word
+  static const std::size_t CODES_PER_WORD = 10;
+  //! number of bits of a code
+  static const unsigned int BITS_PER_CODE = 3;
+
+  typedef ChainCode value_type;
+  typedef std::size_t size_type;
+
+  /**
+   * @class const_iterator
+   * @brief Forward iterator over the codes of a ChainCodeContainer
+   */
+  class const_iterator
+  {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef ChainCode value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const ChainCode* pointer;
+    typedef ChainCode reference;
+
+    inline const_iterator();
+    inline const_iterator(const unsigned int* pWord, std::size_t slot);
+
+    inline ChainCode operator*() const;
+    inline const_iterator& operator++();
+    inline const_iterator operator++(int);
+    inline bool operator==(const const_iterator& other) const;
+    inline bool operator!=(const const_iterator& other) const;
+
+   private:
+    //! word holding the current code
+    const unsigned int* mpWord;
+    //! index of the current code in its word
+    std::size_t mSlot;
+  };
+
+  ChainCodeContainer();
+
+  /**
+   * @brief Adds \p code at the end. \p code must be valid
+   */
+  inline void push_back(ChainCode code);
+
+  /**
+   * @brief Adds all of the codes of \p other at the end
+   */
+  void append(const ChainCodeContainer& other);
+
+  /**
+   * @brief Makes room for \p numCodes codes without reallocating
+   */
+  void reserve(std::size_t numCodes);
+
+  /**
+   * @brief Removes all of the codes
+   */
+  void clear();
+
+  /**
+   * @brief Swaps the codes of this container with the ones of \p other
+   */
+  void swap(ChainCodeContainer& other);
+
+  inline bool empty() const;
+  inline std::size_t size() const;
+
+  inline const_iterator begin() const;
+  inline const_iterator end() const;
+
+ private:
+
+  //! packed codes, code i is in the bits [3 * (i % 10), 3 * (i % 10) + 3) of
+  //! the word i / 10
+  std::vector<unsigned int> mWords;
+  //! number of codes
+  std::size_t mSize;
+};
+
+inline ChainCodeContainer::const_iterator::const_iterator()
+    : mpWord(NULL),
+      mSlot(0)
+{}
+
+inline ChainCodeContainer::const_iterator::const_iterator(
+    const unsigned int* pWord,
+    std::size_t slot)
+    : mpWord(pWord),
+      mSlot(slot)
+{}
+
+inline ChainCode ChainCodeContainer::const_iterator::operator*() const
+{
+  return static_cast<ChainCode>((*mpWord >> (BITS_PER_CODE * mSlot)) & 0x7u);
+}
+
+inline ChainCodeContainer::const_iterator&
+ChainCodeContainer::const_iterator::operator++()
+{
+  if (++mSlot == CODES_PER_WORD)
+  {
+    mSlot = 0;
+    ++mpWord;
+  }
+  return *this;
+}
+
+inline ChainCodeContainer::const_iterator
+ChainCodeContainer::const_iterator::operator++(int)
+{
+  const_iterator previous(*this);
+  ++(*this);
+  return previous;
+}
+
+inline bool ChainCodeContainer::const_iterator::operator==(
+    const const_iterator& other) const
+{
+  return mpWord == other.mpWord && mSlot == other.mSlot;
+}
+
+inline bool ChainCodeContainer::const_iterator::operator!=(
+    const const_iterator& other) const
+{
+  return !(*this == other);
+}
+
+inline void ChainCodeContainer::push_back(ChainCode code)
+{
+  const std::size_t slot = mSize % CODES_PER_WORD;
+  if (slot == 0)
+  {
+    mWords.push_back(0);
+  }
+  mWords.back() |= static_cast<unsigned int>(code) << (BITS_PER_CODE * slot);
+  ++mSize;
+}
+
+inline bool ChainCodeContainer::empty() const
+{
+  return mSize == 0;
+}
+
+inline std::size_t ChainCodeContainer::size() const
+{
+  return mSize;
+}
+
+inline ChainCodeContainer::const_iterator ChainCodeContainer::begin() const
+{
+  if (mWords.empty())
+  {
+    return const_iterator();
+  }
+  return const_iterator(&mWords[0], 0);
+}
+
+inline ChainCodeContainer::const_iterator ChainCodeContainer::end() const
+{
+  if (mWords.empty())
+  {
+    return const_iterator();
+  }
+  return const_iterator(&mWords[0] + mSize / CODES_PER_WORD,
+                        mSize % CODES_PER_WORD);
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_CHAINCODECONTAINER_H_
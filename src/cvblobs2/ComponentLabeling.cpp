@@ -7,6 +7,9 @@
 
 #include <cvblobs2/Blob.h>
 #include <cvblobs2/BlobContour.h>
+#include <cvblobs2/LabelingWorkspace.h>
+#include <cvblobs2/RunLengthLabeling.h>
+#include <cvblobs2/ScanlineSkip.h>
 
 namespace {
 
@@ -20,10 +23,6 @@ inline bool GET_IMAGEMASK_PIXEL(const cv::Mat& maskImage, const cv::Point& point
   // for our mask image
   return maskImage.at<unsigned char>(point) > 0;
 }
-inline bool GET_BELOW_VISITEDPIXEL(bool* pCurrentPixel, int imageWidth)
-{
-	return *(pCurrentPixel + imageWidth);
-}
 
 /**
    - FUNCI: ASSIGN_LABEL
@@ -54,16 +53,74 @@ inline void ASSIGN_VISITED(const cv::Point& point,
 	*(pVisitedPoints + point.y * imageWidth + point.x) = true;
 }
 
+/**
+ * @brief Searches for the next contour pixel around the pixel at
+ * \p position of a padded foreground map, starting with \p initialMovement.
+ * Background neighbours that are checked are marked as visited in the map,
+ * when \p bMarkVisited is true.
+ * @return the movement to the next contour pixel or CHAIN_CODE_INVALID for
+ * an isolated pixel
+ */
+inline cvblobs::ChainCode PADDED_TRACER(unsigned char* pForegroundMap,
+                                        bool bMarkVisited,
+                                        const int* pNeighbourOffsets,
+                                        int position,
+                                        int initialMovement)
+{
+  for (int direction = 0; direction < cvblobs::CHAIN_CODE_MAX; ++direction)
+  {
+    const int movement = (initialMovement + direction) % cvblobs::CHAIN_CODE_MAX;
+    unsigned char& neighbour = pForegroundMap[position + pNeighbourOffsets[movement]];
+    if (neighbour & cvblobs::LabelingWorkspace::MAP_FOREGROUND)
+    {
+      return static_cast<cvblobs::ChainCode>(movement);
+    }
+    else if (bMarkVisited)
+    {
+      neighbour |= cvblobs::LabelingWorkspace::MAP_VISITED;
+    }
+  }
+  return cvblobs::CHAIN_CODE_INVALID;
+}
+
+/**
+ * @brief Adds the run [colBegin, colEnd) of row \p row to the moments of the
+ * label of its first pixel. The whole run is 8-connected so it has one label.
+ */
+inline void ADD_RUN_MOMENTS(const cvblobs::LabelType* pLabelsRow,
+                            int row,
+                            int colBegin,
+                            int colEnd,
+                            std::vector<cvblobs::PixelMoments>& labelMoments)
+{
+  labelMoments[pLabelsRow[colBegin] - 1].addRun(row, colBegin, colEnd);
+}
+
 } // end anonymous namespace
 
 CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! Labels \p inputImage, the label buffer is handed to \p pLabelImage when
+//! it isn't NULL
+bool labelComponents(const cv::Mat& inputImage,
+                     const cv::Mat& maskImage,
+                     const PixelCondition& foreground,
+                     BlobContainerType& blobs,
+                     LabelingWorkspace& workspace,
+                     cv::Mat* pLabelImage,
+                     int flags);
+
+} // end anonymous namespace
+
 /**
    - FUNCI: ComponentLabeling
    - FUNCIONALITAT: Calcula els components binaris (blobs) d'una imatge amb connectivitat a 8
    - PARMETRES:
    - inputImage: image to segment (pixel values different than blobColor are treated as background)
    - maskImage: if not NULL, all the pixels equal to 0 in mask are skipped in input image
-   - backgroundColor: color of background (ignored pixels)
+   - foreground: color of background (ignored pixels) or condition of the foreground pixels
    - blobs: blob vector destination
    - RESULTAT:
    - 
@@ -77,22 +134,84 @@ CVBLOBS_BEGIN_NAMESPACE
 */
 bool ComponentLabeling(const cv::Mat& inputImage,
                        const cv::Mat& maskImage,
-                       unsigned char backgroundColor,
-                       BlobContainerType& blobs)
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       int flags /* = LABELING_CONTOUR_TRACING */)
+{
+  // scratch buffers only used by this call
+  LabelingWorkspace workspace;
+  return ComponentLabeling(inputImage,
+                           maskImage,
+                           foreground,
+                           blobs,
+                           workspace,
+                           flags);
+}
+
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       int flags /* = LABELING_CONTOUR_TRACING */)
+{
+  return labelComponents(inputImage,
+                         maskImage,
+                         foreground,
+                         blobs,
+                         workspace,
+                         NULL, // no label image
+                         flags);
+}
+
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       cv::Mat& labelImage,
+                       int flags /* = LABELING_CONTOUR_TRACING */)
+{
+  // the label image keeps the buffer alive once the workspace is gone
+  LabelingWorkspace workspace;
+  return labelComponents(inputImage,
+                         maskImage,
+                         foreground,
+                         blobs,
+                         workspace,
+                         &labelImage,
+                         flags);
+}
+
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       cv::Mat& labelImage,
+                       int flags /* = LABELING_CONTOUR_TRACING */)
+{
+  return labelComponents(inputImage,
+                         maskImage,
+                         foreground,
+                         blobs,
+                         workspace,
+                         &labelImage,
+                         flags);
+}
+
+namespace {
+
+bool labelComponents(const cv::Mat& inputImage,
+                     const cv::Mat& maskImage,
+                     const PixelCondition& foreground,
+                     BlobContainerType& blobs,
+                     LabelingWorkspace& workspace,
+                     cv::Mat* pLabelImage,
+                     int flags)
 {
   bool b_internal_contour = false;
   bool b_external_contour = false;
 
-  // pointers into the input image
-	const unsigned char* p_input_image_iter       = NULL;
-  const unsigned char* p_above_input_image_iter = NULL;
-  const unsigned char* p_below_input_image_iter = NULL;
-
-  // pointers into the mask image
-  const unsigned char* p_mask_iter       = NULL;
-  const unsigned char* p_above_mask_iter = NULL;
-  const unsigned char* p_below_mask_iter = NULL;
-  
   //! current blob pointer
   cv::Ptr<Blob> p_current_blob;
   cv::Point current_point;
@@ -107,31 +226,71 @@ bool ComponentLabeling(const cv::Mat& inputImage,
   const cv::Size mask_size  = maskImage.size();
   
 	// verify that input image and mask image has same size
-	if (!maskImage.empty())
+	if (!maskImage.empty() &&
+      (mask_size != image_size || maskImage.type() != CV_8UC1))
 	{
-		if (mask_size != image_size)
+    return false;
+	}
+
+  // 8U, 16U or 32F single channel images
+  if (!LabelingWorkspace::isSupportedType(inputImage.type()))
+  {
+    return false;
+  }
+
+  const bool b_accumulate_moments = (flags & LABELING_ACCUMULATE_MOMENTS) != 0;
+
+  if (flags & (LABELING_RUN_LENGTH | LABELING_PARALLEL))
+  {
+    const bool b_parallel = (flags & LABELING_PARALLEL) != 0;
+    if (pLabelImage != NULL)
     {
-      return false;
+      return runLengthLabeling(inputImage,
+                               maskImage,
+                               foreground,
+                               blobs,
+                               workspace,
+                               *pLabelImage,
+                               b_parallel,
+                               b_accumulate_moments);
     }
-	}
-	else
-	{
-		p_mask_iter       = NULL;
-		p_above_mask_iter = NULL;
-		p_below_mask_iter = NULL;
-	}
+    return runLengthLabeling(inputImage,
+                             maskImage,
+                             foreground,
+                             blobs,
+                             workspace,
+                             b_parallel,
+                             b_accumulate_moments);
+  }
 
-  const int num_pixels = image_size.width * image_size.height;
-  
-	// row major vector with labelled image (deleted at end of function)
-	LabelType* p_labels = new LabelType[num_pixels];
-	memset(p_labels, 0, num_pixels * sizeof(LabelType) ) ;
-  LabelType* p_labels_iter = p_labels;
+  // a label image of the previous frame would keep the workspace from
+  // reusing its buffer
+  if (pLabelImage != NULL)
+  {
+    pLabelImage->release();
+  }
+  workspace.prepare(image_size);
+
+  // 1 pixel padded foreground map, the input and the mask aren't read again
+  workspace.buildForegroundMap(inputImage,
+                               maskImage,
+                               foreground,
+                               0,
+                               image_size.height);
+  const int foreground_step = workspace.foregroundStep();
+
+  // zeroed row major labelled image, owned by workspace. Visited points are
+  // marked in the foreground map
+	LabelType* p_labels = workspace.labels();
+
+  // rows holding foreground pixels, labels are only written on these rows
+  int first_foreground_row = -1;
+  int last_foreground_row = -1;
 
-  // row major vector with visited points (deleted at end of function)
-	bool* p_visited_points = new bool[num_pixels];
-	memset(p_visited_points, false, num_pixels * sizeof(bool) ) ;
-  bool* p_visited_points_iter = p_visited_points;
+  // pixel moments of the blobs found by this call, indexed by label - 1. They
+  // are accumulated one run of foreground pixels at a time
+  const std::size_t first_blob = blobs.size();
+  std::vector<PixelMoments> label_moments;
 
 	// start labelling with 1 being the first label ID
   int current_label = 1;
@@ -139,152 +298,165 @@ bool ComponentLabeling(const cv::Mat& inputImage,
 
 	for (int row = 0; row < image_size.height; ++row)
 	{
-		// don't verify if we area on first or last row,
-    // it will verified on pointer access
-		p_input_image_iter       = inputImage.ptr(row);
-		p_above_input_image_iter = inputImage.ptr(row - 1);
-		p_below_input_image_iter = inputImage.ptr(row + 1);
-
-		if (!maskImage.empty())
-		{
-			// don't verify if we area on first or last row,
-      // it will verified on pointer access
-			p_mask_iter       = maskImage.ptr(row);
-			p_above_mask_iter = maskImage.ptr(row - 1);
-			p_below_mask_iter = maskImage.ptr(row + 1);
-		}
+    // the rows above and below are in the border on the first and last rows
+    const unsigned char* p_foreground_row = workspace.foregroundRow(row);
+    const unsigned char* p_above_foreground_row = p_foreground_row - foreground_step;
+    const unsigned char* p_below_foreground_row = p_foreground_row + foreground_step;
+    LabelType* p_labels_row = p_labels + row * image_size.width;
+    // first column of the current run of foreground pixels, -1 if none
+    int run_start = -1;
 		
-		for (int col = 0; col < image_size.width; ++col,
-             ++p_input_image_iter,
-             ++p_above_input_image_iter, ++p_below_input_image_iter,
-             ++p_mask_iter,
-             ++p_above_mask_iter, ++p_below_mask_iter)
+		for (int col = 0; col < image_size.width; ++col)
 		{
 			// ignore background pixels or 0 pixels in mask
-			if (*p_input_image_iter == backgroundColor ||
-          (!maskImage.empty() &&
-           *p_mask_iter == 0 ))
+			if (!(p_foreground_row[col] & LabelingWorkspace::MAP_FOREGROUND))
 			{
-				++p_labels_iter;
-				++p_visited_points_iter;
+        if (run_start >= 0)
+        {
+          ADD_RUN_MOMENTS(p_labels_row, row, run_start, col, label_moments);
+          run_start = -1;
+        }
+        // jump straight to the next foreground pixel of the row, the loop
+        // increment moves past it
+        col = findFlaggedColumn(p_foreground_row,
+                                col + 1,
+                                image_size.width,
+                                LabelingWorkspace::MAP_FOREGROUND) - 1;
 				continue;
 			}
-			
-			// new external contour: current label == 0 and above pixel is background
-			if (row > 0 )
-			{
-				b_external_contour = ( ((*p_above_input_image_iter == backgroundColor) || 
-                                (!maskImage.empty() &&
-                                 *p_above_mask_iter == 0)) && 
-                               (*p_labels_iter == 0));
-			}
-			else
+
+      if (first_foreground_row < 0)
       {
-				b_external_contour = (*p_labels_iter == 0);
+        first_foreground_row = row;
       }
-
-			// new internal contour: below pixel is background and not visited
-			if (!b_external_contour && row < image_size.height - 1)
-			{
-				b_internal_contour = *p_below_input_image_iter == backgroundColor &&
-            !GET_BELOW_VISITEDPIXEL( p_visited_points_iter, image_size.width);
-			}
-			else
-			{
-				b_internal_contour = false;
-			}
-			
+      last_foreground_row = row;
 			
+			// new external contour: current label == 0 and above pixel is background
+      b_external_contour =
+          !(p_above_foreground_row[col] & LabelingWorkspace::MAP_FOREGROUND) &&
+          p_labels_row[col] == 0;
+
 			if (b_external_contour)
 			{
 				current_point = cv::Point(col, row); // (x, y)
 				// assign label to labelled image
-				*p_labels_iter = current_label;
+				p_labels_row[col] = current_label;
 				
 				// create new blob
-				p_current_blob = cv::Ptr<Blob>(new Blob(current_label,
-                                                current_point,
-                                                image_size));
+				p_current_blob = workspace.createBlob(current_label,
+                                              current_point,
+                                              image_size);
         
 				// contour tracing with current_label
-				contourTracing(inputImage,
-                       maskImage,
+				contourTracing(workspace,
                        current_point, 
                        p_labels,
-                       p_visited_points, 
+                       true, // mark visited points
                        current_label,
                        false,
-                       backgroundColor,
                        p_current_blob->externalContour());
 
 				// add new created blob
 				blobs.push_back(p_current_blob);
+        if (b_accumulate_moments)
+        {
+          label_moments.push_back(PixelMoments());
+        }
 
 				++current_label;
 			} // end if (b_external_contour)
-			else 
+
+			// new internal contour: below pixel is background and not visited.
+			// Checked after the external contour tracing, that marks the outer
+			// background around a new blob as visited
+      // (neither MAP_FOREGROUND nor MAP_VISITED set)
+      b_internal_contour = (row < image_size.height - 1 &&
+                            p_below_foreground_row[col] == 0);
+
+			if (b_internal_contour)
 			{
-				if (b_internal_contour)
-				{
-          current_point = cv::Point(col, row); // (x, y)
-
-					if (*p_labels_iter == 0)
-					{
-						// take left neightbour value as current
-						if (col > 0)
-            {
-							contour_label = *(p_labels_iter - 1);
-            }
-					}
-					else
-					{
-						contour_label = *p_labels_iter;
-					}
-
-					if (contour_label > 0)
-					{
-						p_current_blob = blobs[contour_label - 1];
-            cv::Ptr<BlobContour> p_new_contour(new BlobContour(current_point));
-						
-						// contour tracing with contour_label
-						contourTracing(inputImage,
-                           maskImage,
-                           current_point,
-                           p_labels,
-                           p_visited_points,
-                           contour_label,
-                           true,
-                           backgroundColor,
-                           p_new_contour); 
-
-						p_current_blob->addInternalContour(p_new_contour);
-					} // end if (contour_label > 0)
-				} // end if (b_internal_contour)
-				// neither internal nor external contour
-				else
+        current_point = cv::Point(col, row); // (x, y)
+
+				if (p_labels_row[col] == 0)
 				{
-					// take left neightbour value as current if it is not labelled
-					if (col > 0 && *p_labels_iter == 0)
+					// take left neightbour value as current
+					if (col > 0)
           {
-						*p_labels_iter = *(p_labels_iter - 1);
+						contour_label = p_labels_row[col - 1];
           }
 				}
+				else
+				{
+					contour_label = p_labels_row[col];
+				}
 
-			} // end else (if (b_external_contour))
-			
-			++p_labels_iter;
-			++p_visited_points_iter;
+				if (contour_label > 0)
+				{
+					p_current_blob = blobs[contour_label - 1];
+          cv::Ptr<BlobContour> p_new_contour =
+              workspace.createContour(current_point);
+					
+					// contour tracing with contour_label
+					contourTracing(workspace,
+                         current_point,
+                         p_labels,
+                         true, // mark visited points
+                         contour_label,
+                         true,
+                         p_new_contour); 
+
+					p_current_blob->addInternalContour(p_new_contour);
+				} // end if (contour_label > 0)
+			} // end if (b_internal_contour)
+			// neither internal nor external contour
+			else if (!b_external_contour)
+			{
+				// take left neightbour value as current if it is not labelled
+				if (col > 0 && p_labels_row[col] == 0)
+        {
+					p_labels_row[col] = p_labels_row[col - 1];
+        }
+			}
+
+      if (b_accumulate_moments && run_start < 0)
+      {
+        run_start = col;
+      }
 		} // for each column in image
+
+    if (run_start >= 0)
+    {
+      ADD_RUN_MOMENTS(p_labels_row,
+                      row,
+                      run_start,
+                      image_size.width,
+                      label_moments);
+    }
 	} // for each row in image
 
+  for (std::size_t i = 0; i < label_moments.size(); ++i)
+  {
+    blobs[first_blob + i]->setPixelMoments(label_moments[i]);
+  }
 
- 	// free auxiliary buffers
-	delete [] p_labels;
-	delete [] p_visited_points;
+  // the next labeling with this workspace clears what has been written
+  if (first_foreground_row >= 0)
+  {
+    workspace.markDirty(first_foreground_row, last_foreground_row + 1);
+  }
+
+  // every foreground pixel has been labelled, by the contour tracing or by
+  // its left neighbour
+  if (pLabelImage != NULL)
+  {
+    *pLabelImage = workspace.labelImage();
+  }
 
 	return true;
 }
 
+} // end anonymous namespace
+
 
 
 /**
@@ -333,7 +505,10 @@ void contourTracing(const cv::Mat& inputImage,
   const cv::Size image_size = inputImage.size();
   
 	// assign current label to tnext
-	ASSIGN_LABEL( contourStart, pLabels, image_size.width, label );
+	if (pLabels != NULL)
+	{
+		ASSIGN_LABEL( contourStart, pLabels, image_size.width, label );
+	}
 	
 	// contour corresponds to isolated pixel? 
 	if (tsecond == contourStart)
@@ -346,7 +521,10 @@ void contourTracing(const cv::Mat& inputImage,
 	pCurrentBlobContour->addChainCode(movement);
 	
 	// assign label to next point 
-	ASSIGN_LABEL( tsecond, pLabels, image_size.width, label );
+	if (pLabels != NULL)
+	{
+		ASSIGN_LABEL( tsecond, pLabels, image_size.width, label );
+	}
 	
   cv::Point t     = tsecond;
   cv::Point tnext = tsecond;
@@ -370,7 +548,10 @@ void contourTracing(const cv::Mat& inputImage,
                    movement); // out param
 		
 		// assign label to contour point
-		ASSIGN_LABEL( tnext, pLabels, image_size.width, label );
+		if (pLabels != NULL)
+		{
+			ASSIGN_LABEL( tnext, pLabels, image_size.width, label );
+		}
 
 		// add chain code to current contour
 		pCurrentBlobContour->addChainCode(movement);
@@ -423,7 +604,7 @@ cv::Point tracer(const cv::Mat& inputImage,
 		{
 			return next_point;
 		}
-		else
+		else if (pVisitedPoints != NULL)
 		{
 			// mark point as visited
 			ASSIGN_VISITED(next_point, pVisitedPoints, image_size.width);
@@ -436,4 +617,75 @@ cv::Point tracer(const cv::Mat& inputImage,
 	return next_point;
 }
 
+void contourTracing(LabelingWorkspace& workspace,
+                    const cv::Point& contourStart,
+                    LabelType* pLabels,
+                    bool bMarkVisited,
+                    LabelType label,
+                    bool bInternalContour,
+                    cv::Ptr<BlobContour> pCurrentBlobContour)
+{
+  unsigned char* p_foreground_map = workspace.foregroundMap();
+  const int* p_neighbour_offsets = workspace.neighbourOffsets();
+  const int* p_label_offsets = workspace.labelOffsets();
+
+  // the same contour is followed as the one of the cv::Mat version, but
+  // positions are indices in the padded buffers instead of points
+  const int start_position =
+      contourStart.y * workspace.foregroundStep() + contourStart.x;
+  const int start_label_position =
+      contourStart.y * workspace.size().width + contourStart.x;
+
+  int movement = PADDED_TRACER(p_foreground_map,
+                               bMarkVisited,
+                               p_neighbour_offsets,
+                               start_position,
+                               bInternalContour ? CHAIN_CODE_DOWN_RIGHT : CHAIN_CODE_UP_LEFT);
+
+  if (pLabels != NULL)
+  {
+    pLabels[start_label_position] = label;
+  }
+
+  // contour corresponds to isolated pixel?
+  if (movement == CHAIN_CODE_INVALID)
+  {
+    return;
+  }
+
+  pCurrentBlobContour->addChainCode(static_cast<ChainCode>(movement));
+
+  const int second_position = start_position + p_neighbour_offsets[movement];
+  int label_position = start_label_position + p_label_offsets[movement];
+  if (pLabels != NULL)
+  {
+    pLabels[label_position] = label;
+  }
+
+  int position      = second_position;
+  int next_position = second_position;
+
+  // follow contour until start point is reached again
+  while (position != start_position ||
+         next_position != second_position)
+  {
+    position = next_position;
+
+    // search for next contour point
+    movement = PADDED_TRACER(p_foreground_map,
+                             bMarkVisited,
+                             p_neighbour_offsets,
+                             position,
+                             (movement + 5) % CHAIN_CODE_MAX);
+    next_position = position + p_neighbour_offsets[movement];
+    label_position += p_label_offsets[movement];
+
+    if (pLabels != NULL)
+    {
+      pLabels[label_position] = label;
+    }
+    pCurrentBlobContour->addChainCode(static_cast<ChainCode>(movement));
+  }
+}
+
 CVBLOBS_END_NAMESPACE
@@ -9,16 +9,69 @@
 #define _CVBLOBS2_COMPONENTLABELING_H_
 
 #include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/PixelCondition.h>
 
 CVBLOBS_BEGIN_NAMESPACE
 
-//! Component labeling functionx
+/**
+ * @brief Finds the 8-connected blobs of \p inputImage.
+ * @param inputImage image to label, CV_8UC1, CV_16UC1 or CV_32FC1
+ * @param maskImage if not empty, pixels equal to 0 in the mask are skipped
+ * (CV_8UC1)
+ * @param foreground selects the foreground pixels: either a background
+ * color, converted to the pixel type of \p inputImage, or a FilterCondition
+ * on the pixel values so a grayscale image can be labeled without
+ * thresholding it first. See PixelCondition.
+ * @param blobs the found blobs are appended to this container in id order
+ * @param flags LabelingFlags selecting the labeling algorithm. Every
+ * algorithm produces the same blobs with the same ids.
+ * @return false if \p inputImage is empty or of another type, or if
+ * \p maskImage has another size or type
+ */
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       int flags = LABELING_CONTOUR_TRACING);
+
+/**
+ * @brief Same as above but the scratch buffers are taken from \p workspace.
+ * Reusing one workspace for every frame avoids allocating and clearing the
+ * buffers on every call.
+ */
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       int flags = LABELING_CONTOUR_TRACING);
+
+/**
+ * @brief Same as above and also returns the labelled image.
+ * @param labelImage set to a CV_32SC1 image holding, for every pixel, the
+ * id() of the blob found by this call it belongs to, interior pixels
+ * included, and 0 for the background. It shares the label buffer used by the
+ * labeling, no copy is made. Its previous content is released first, so
+ * passing the label image of the previous frame back lets the buffer be
+ * reused.
+ */
+bool ComponentLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       cv::Mat& labelImage,
+                       int flags = LABELING_CONTOUR_TRACING);
+
 bool ComponentLabeling(const cv::Mat& inputImage,
                        const cv::Mat& maskImage,
-                       unsigned char backgroundColor,
-                       BlobContainerType& blobs);
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       cv::Mat& labelImage,
+                       int flags = LABELING_CONTOUR_TRACING);
 
 //! Auxiliary functions
+//! \p labels and \p pbVisitedPoints may be NULL when they aren't needed
 void contourTracing(const cv::Mat& inputImage,
                     const cv::Mat& maskImage,
                     const cv::Point& contourStart,
@@ -29,6 +82,23 @@ void contourTracing(const cv::Mat& inputImage,
                     unsigned char backgroundColor,
                     cv::Ptr<BlobContour> pCurrentBlobContour);
 
+/**
+ * @brief Same as above but follows the contour on the padded foreground map
+ * of \p workspace, without any bounds check.
+ * @pre the foreground map of \p workspace is built
+ * @param pLabels label buffer of \p workspace, may be NULL
+ * @param bMarkVisited mark the visited background pixels in the foreground
+ * map. When false \p workspace is only read and several contours can be
+ * traced at once.
+ */
+void contourTracing(LabelingWorkspace& workspace,
+                    const cv::Point& contourStart,
+                    LabelType* pLabels,
+                    bool bMarkVisited,
+                    LabelType label,
+                    bool bInternalContour,
+                    cv::Ptr<BlobContour> pCurrentBlobContour);
+
 cv::Point tracer(const cv::Mat& inputImage,
                  const cv::Mat& maskImage,
                  const cv::Point& point,
@@ -0,0 +1,318 @@
+#include <cvblobs2/ConvexHull.h>
+
+#include <limits.h>
+#include <algorithm>
+#include <cmath>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! Cross product of (a - o) and (b - o), > 0 if o, a, b turn
+//! counter-clockwise with the y axis pointing up
+inline double cross(const cv::Point& o, const cv::Point& a, const cv::Point& b)
+{
+  return static_cast<double>(a.x - o.x) * (b.y - o.y) -
+         static_cast<double>(a.y - o.y) * (b.x - o.x);
+}
+
+//! Distance between \p a and \p b
+inline double distance(const cv::Point& a, const cv::Point& b)
+{
+  const double dx = b.x - a.x;
+  const double dy = b.y - a.y;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+//! Direction of the vector (\p dx, \p dy) in degrees in [0, 180)
+double directionAngle(double dx, double dy)
+{
+  double angle = std::atan2(dy, dx) * 180.0 / CV_PI;
+  if (angle < 0.0)
+  {
+    angle += 180.0;
+  }
+  if (angle >= 180.0)
+  {
+    angle -= 180.0;
+  }
+  return angle;
+}
+
+//! Twice the area of the triangle of the edge \p i of \p hull and its point
+//! \p j, proportional to the distance of the point to the edge
+inline double edgeArea(const PointContainerType& hull,
+                       std::size_t i,
+                       std::size_t j)
+{
+  const std::size_t n = hull.size();
+  return std::fabs(cross(hull[i], hull[(i + 1) % n], hull[j % n]));
+}
+
+//! Position of the point \p j of \p hull along the edge \p i
+inline double edgePosition(const PointContainerType& hull,
+                           std::size_t i,
+                           std::size_t j)
+{
+  const std::size_t n = hull.size();
+  const cv::Point& a = hull[i];
+  const cv::Point& b = hull[(i + 1) % n];
+  const cv::Point& p = hull[j % n];
+  return static_cast<double>(b.x - a.x) * (p.x - a.x) +
+         static_cast<double>(b.y - a.y) * (p.y - a.y);
+}
+
+//! Advances \p j, modulo the size of \p hull, to the point of \p hull the
+//! farthest from its edge \p i. Turning from one edge to the next, that
+//! point only moves forward.
+inline void farthestFromEdge(const PointContainerType& hull,
+                             std::size_t i,
+                             std::size_t& j)
+{
+  while (edgeArea(hull, i, j + 1) > edgeArea(hull, i, j))
+  {
+    j = (j + 1) % hull.size();
+  }
+}
+
+} // end anonymous namespace
+
+void contourConvexHull(const PointContainerType& contour,
+                       PointContainerType& hull)
+{
+  hull.clear();
+  const std::size_t num_points = contour.size();
+  if (num_points == 0)
+  {
+    return;
+  }
+
+  int min_x = INT_MAX;
+  int max_x = INT_MIN;
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    min_x = std::min(min_x, contour[i].x);
+    max_x = std::max(max_x, contour[i].x);
+  }
+  // not a contour of neighbouring points, sorting them is cheaper
+  const std::size_t num_columns = static_cast<std::size_t>(max_x - min_x) + 1;
+  if (num_columns > num_points)
+  {
+    cv::convexHull(contour, hull, true);
+    return;
+  }
+
+  // only the highest and lowest point of a column can be on the hull
+  std::vector<int> min_y(num_columns, INT_MAX);
+  std::vector<int> max_y(num_columns, INT_MIN);
+  for (std::size_t i = 0; i < num_points; ++i)
+  {
+    const std::size_t c = contour[i].x - min_x;
+    min_y[c] = std::min(min_y[c], contour[i].y);
+    max_y[c] = std::max(max_y[c], contour[i].y);
+  }
+  std::vector<cv::Point> points;
+  points.reserve(2 * num_columns);
+  for (std::size_t c = 0; c < num_columns; ++c)
+  {
+    if (min_y[c] == INT_MAX)
+    {
+      continue;
+    }
+    const int x = min_x + static_cast<int>(c);
+    points.push_back(cv::Point(x, min_y[c]));
+    if (max_y[c] != min_y[c])
+    {
+      points.push_back(cv::Point(x, max_y[c]));
+    }
+  }
+  if (points.size() < 3)
+  {
+    hull.assign(points.rbegin(), points.rend());
+    return;
+  }
+
+  // Andrew's monotone chain over the points, already sorted by x then y:
+  // the lower chain left to right, then the upper one right to left
+  std::vector<cv::Point> chain(2 * points.size());
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    while (k >= 2 && cross(chain[k - 2], chain[k - 1], points[i]) <= 0.0)
+    {
+      --k;
+    }
+    chain[k++] = points[i];
+  }
+  const std::size_t lower_size = k + 1;
+  for (std::size_t i = points.size() - 1; i > 0; --i)
+  {
+    while (k >= lower_size &&
+           cross(chain[k - 2], chain[k - 1], points[i - 1]) <= 0.0)
+    {
+      --k;
+    }
+    chain[k++] = points[i - 1];
+  }
+
+  // the last point closes the chain, clockwise with the y axis pointing up
+  // like cv::convexHull()
+  hull.assign(chain.rend() - (k - 1), chain.rend());
+}
+
+double hullMaxFeretDiameter(const PointContainerType& hull, double& angle)
+{
+  angle = 0.0;
+  const std::size_t n = hull.size();
+  if (n < 2)
+  {
+    return 0.0;
+  }
+
+  // the farthest points are antipodal: one is the farthest from an edge
+  // ending at the other
+  double diameter = 0.0;
+  std::size_t j = 1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    farthestFromEdge(hull, i, j);
+    // an edge parallel to the edge i has two farthest points
+    const std::size_t last_j =
+        (edgeArea(hull, i, j + 1) == edgeArea(hull, i, j)) ? j + 1 : j;
+    for (std::size_t k = j; k <= last_j; ++k)
+    {
+      const cv::Point& far_point = hull[k % n];
+      for (std::size_t e = i; e <= i + 1; ++e)
+      {
+        const cv::Point& edge_point = hull[e % n];
+        const double d = distance(edge_point, far_point);
+        if (d > diameter)
+        {
+          diameter = d;
+          angle = directionAngle(far_point.x - edge_point.x,
+                                 far_point.y - edge_point.y);
+        }
+      }
+    }
+  }
+  return diameter;
+}
+
+double hullMinFeretDiameter(const PointContainerType& hull, double& angle)
+{
+  angle = 0.0;
+  const std::size_t n = hull.size();
+  if (n < 2)
+  {
+    return 0.0;
+  }
+  if (n == 2)
+  {
+    angle = directionAngle(hull[0].y - hull[1].y, hull[1].x - hull[0].x);
+    return 0.0;
+  }
+
+  // the smallest width lies on an edge, against the point the farthest
+  // from it
+  double diameter = 0.0;
+  std::size_t j = 1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    farthestFromEdge(hull, i, j);
+    const cv::Point& a = hull[i];
+    const cv::Point& b = hull[(i + 1) % n];
+    const double width = edgeArea(hull, i, j) / distance(a, b);
+    if (i == 0 || width < diameter)
+    {
+      diameter = width;
+      angle = directionAngle(a.y - b.y, b.x - a.x);
+    }
+  }
+  return diameter;
+}
+
+cv::RotatedRect hullMinAreaRect(const PointContainerType& hull)
+{
+  const std::size_t n = hull.size();
+  if (n == 0)
+  {
+    return cv::RotatedRect();
+  }
+  if (n == 1)
+  {
+    return cv::RotatedRect(cv::Point2f(hull[0].x, hull[0].y),
+                           cv::Size2f(0.0f, 0.0f),
+                           0.0f);
+  }
+
+  // the rectangle on every edge is bounded by the points the farthest
+  // along the edge, backwards and from the edge. They move forward as the
+  // calipers turn, starting in that order from the end of the edge.
+  double min_area = 0.0;
+  cv::RotatedRect min_rect;
+  std::size_t forward = 1;
+  std::size_t farthest = 1;
+  std::size_t backward = 1;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    while (edgePosition(hull, i, forward + 1) >
+           edgePosition(hull, i, forward))
+    {
+      forward = (forward + 1) % n;
+    }
+    if (i == 0)
+    {
+      farthest = forward;
+    }
+    farthestFromEdge(hull, i, farthest);
+    if (i == 0)
+    {
+      backward = farthest;
+    }
+    while (edgePosition(hull, i, backward + 1) <
+           edgePosition(hull, i, backward))
+    {
+      backward = (backward + 1) % n;
+    }
+
+    const cv::Point& a = hull[i];
+    const cv::Point& b = hull[(i + 1) % n];
+    const double edge_length = distance(a, b);
+    const double max_position = edgePosition(hull, i, forward) / edge_length;
+    const double min_position = edgePosition(hull, i, backward) / edge_length;
+    const double length = max_position - min_position;
+    const double height = cross(a, b, hull[farthest]) / edge_length;
+    const double area = length * std::fabs(height);
+    if (i != 0 && area >= min_area)
+    {
+      continue;
+    }
+    min_area = area;
+
+    // unit vectors along the edge and perpendicular to it, towards the hull
+    // when height is positive
+    const double ux = (b.x - a.x) / edge_length;
+    const double uy = (b.y - a.y) / edge_length;
+    const double middle = (max_position + min_position) / 2.0;
+    min_rect.center = cv::Point2f(
+        static_cast<float>(a.x + ux * middle - uy * height / 2.0),
+        static_cast<float>(a.y + uy * middle + ux * height / 2.0));
+    if (length >= std::fabs(height))
+    {
+      min_rect.size = cv::Size2f(static_cast<float>(length),
+                                 static_cast<float>(std::fabs(height)));
+      min_rect.angle = static_cast<float>(directionAngle(ux, uy));
+    }
+    else
+    {
+      min_rect.size = cv::Size2f(static_cast<float>(std::fabs(height)),
+                                 static_cast<float>(length));
+      min_rect.angle = static_cast<float>(directionAngle(-uy, ux));
+    }
+  }
+  return min_rect;
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,57 @@
+/**
+ * @brief Convex hull of the traced contours of blobs
+ */
+#ifndef _CVBLOBS2_CONVEXHULL_H_
+#define _CVBLOBS2_CONVEXHULL_H_
+
+#include <cvblobs2/CvBlobsFwd.h>
+#include <opencv2/core/core.hpp>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Sets \p hull to the convex hull of \p contour, in O(n) when its
+ * consecutive points are neighbouring pixels like the ones of
+ * BlobContour::contourPoints().
+ *
+ * Such a contour spans fewer columns than it has points, so keeping the
+ * highest and lowest point of every column sorts the hull candidates without
+ * comparing them, and Andrew's monotone chain joins them. Any other set of
+ * points is passed to cv::convexHull().
+ *
+ * The hull is clockwise, like cv::convexHull(contour, hull, true), without
+ * collinear points. Collinear points give the two ends of their segment.
+ */
+void contourConvexHull(const PointContainerType& contour,
+                       PointContainerType& hull);
+
+/**
+ * @brief Returns the maximum Feret diameter of the convex polygon \p hull,
+ * the largest distance between two of its points, and sets \p angle to the
+ * direction of that segment.
+ *
+ * This and the functions below take a hull without collinear points, like
+ * the one of contourConvexHull(), and run rotating calipers over it in
+ * O(n). Angles are in degrees in [0, 180), from the x axis towards the y
+ * axis of the image. A hull of less than two points measures 0 at angle 0.
+ */
+double hullMaxFeretDiameter(const PointContainerType& hull, double& angle);
+
+/**
+ * @brief Returns the minimum Feret diameter of the convex polygon \p hull,
+ * its smallest width between two parallel lines, and sets \p angle to the
+ * direction the width is measured in, perpendicular to the lines
+ */
+double hullMinFeretDiameter(const PointContainerType& hull, double& angle);
+
+/**
+ * @brief Returns the rotated rectangle of smallest area containing the
+ * convex polygon \p hull. One of its sides lies on an edge of the hull.
+ * The width of the rectangle is its longer side and the angle is the
+ * direction of that side.
+ */
+cv::RotatedRect hullMinAreaRect(const PointContainerType& hull);
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_CONVEXHULL_H_
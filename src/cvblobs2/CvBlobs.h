@@ -9,10 +9,20 @@
 #include <cvblobs2/CvBlobsFwd.h>
 #include <cvblobs2/BlobContour.h>
 #include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobArena.h>
+#include <cvblobs2/BlobClustering.h>
+#include <cvblobs2/BlobFilter.h>
 #include <cvblobs2/BlobLibraryConfiguration.h>
 #include <cvblobs2/BlobOperators.h>
+#include <cvblobs2/BlobProperties.h>
 #include <cvblobs2/BlobResult.h>
+#include <cvblobs2/BlobSpatialIndex.h>
+#include <cvblobs2/BlobTracker.h>
 #include <cvblobs2/ChainCode.h>
 #include <cvblobs2/ComponentLabeling.h>
+#include <cvblobs2/FeatureTable.h>
+#include <cvblobs2/LabelingWorkspace.h>
+#include <cvblobs2/PixelCondition.h>
+#include <cvblobs2/RunLengthLabeling.h>
 
 #endif // _CVBLOBS2_CVBLOBS_H_
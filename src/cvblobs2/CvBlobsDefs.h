@@ -10,6 +10,7 @@
 #undef CVBLOBS_BEGIN_NAMESPACE
 #undef CVBLOBS_END_NAMESPACE
 #undef CVBLOBS_DISALLOW_EVIL_CONSTRUCTORS
+#undef CVBLOBS_STATIC_ASSERT
 #undef CVBLOBS_PI
 
 //! namespace helpers
@@ -22,6 +23,11 @@
   TypeName(const TypeName&);                          \
   void operator=(const TypeName&);
 
+//! compile time check of \p condition, fails with an array of negative size
+//! named after \p name
+#define CVBLOBS_STATIC_ASSERT(condition, name) \
+  typedef char name[(condition) ? 1 : -1]
+
 //! pi
 #define CVBLOBS_PI 3.1415926535897932384626433832795
 #define CVBLOBS_DEGREE2RAD (CVBLOBS_PI / 180.0)
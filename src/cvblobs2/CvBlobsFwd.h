@@ -8,7 +8,6 @@
 #ifndef _CVBLOBS2_BLOBFWD_H_
 #define _CVBLOBS2_BLOBFWD_H_
 
-#include <list>
 #include <vector>
 
 #include <cvblobs2/CvBlobsDefs.h>
@@ -21,9 +20,19 @@ CVBLOBS_BEGIN_NAMESPACE
 
 //! Class forward declares
 class Blob;
+class BlobArena;
 class BlobContour;
+class BlobFilter;
 class BlobOperator;
+class BlobProperties;
 class BlobResult;
+class BlobSpatialIndex;
+class BlobTracker;
+class ChainCodeContainer;
+class FeatureTable;
+class LabelingWorkspace;
+class PixelCondition;
+class Track;
 
 //! Actions performed by a filter (include or exclude blobs)
 enum FilterAction
@@ -47,11 +56,113 @@ enum FilterCondition
   CONDITION_OUTSIDE			     = 10
 };
 
+//! Flags that select how ComponentLabeling() extracts the blobs of an image
+enum LabelingFlags
+{
+  //! Chang et al. contour tracing (default)
+  LABELING_CONTOUR_TRACING = 0x00,
+  //! Row runs joined with a union-find, contours traced afterwards
+  LABELING_RUN_LENGTH      = 0x01,
+  //! Run-length labeling split in horizontal bands between threads
+  LABELING_PARALLEL        = 0x02,
+  //! Accumulate the area, bounding box and moments of every blob from its
+  //! pixels while labeling, see Blob::setPixelMoments()
+  LABELING_ACCUMULATE_MOMENTS = 0x04
+};
+
+//! Slots of the properties cached in a Blob, one per built-in BlobOperator
+//! without parameters, see BlobOperator::propertyId()
+enum PropertyId
+{
+  //! cached under BlobOperator::name() instead of a slot
+  PROPERTY_NAMED = -1,
+  PROPERTY_ID,
+  PROPERTY_AREA,
+  PROPERTY_PERIMETER,
+  PROPERTY_COMPACTNESS,
+  PROPERTY_LENGTH,
+  PROPERTY_BREADTH,
+  PROPERTY_DIFF_X,
+  PROPERTY_DIFF_Y,
+  PROPERTY_HULL_PERIMETER,
+  PROPERTY_HULL_AREA,
+  PROPERTY_MIN_X_AT_MIN_Y,
+  PROPERTY_MIN_Y_AT_MAX_X,
+  PROPERTY_MAX_X_AT_MAX_Y,
+  PROPERTY_MAX_Y_AT_MIN_X,
+  PROPERTY_MIN_X,
+  PROPERTY_MAX_X,
+  PROPERTY_MIN_Y,
+  PROPERTY_MAX_Y,
+  PROPERTY_ELONGATION,
+  PROPERTY_ROUGHNESS,
+  PROPERTY_X_CENTER,
+  PROPERTY_Y_CENTER,
+  PROPERTY_MAJOR_AXIS_LENGTH,
+  PROPERTY_AREA_ELIPSE_RATIO,
+  PROPERTY_MINOR_AXIS_LENGTH,
+  PROPERTY_ORIENTATION,
+  PROPERTY_ELIPSE_X_CENTER,
+  PROPERTY_ELIPSE_Y_CENTER,
+  PROPERTY_ORIENTATION_COS,
+  PROPERTY_AXIS_RATIO,
+  PROPERTY_MAX_FERET_DIAMETER,
+  PROPERTY_MAX_FERET_ANGLE,
+  PROPERTY_MIN_FERET_DIAMETER,
+  PROPERTY_MIN_FERET_ANGLE,
+  PROPERTY_MIN_RECT_LENGTH,
+  PROPERTY_MIN_RECT_BREADTH,
+  PROPERTY_MIN_RECT_ANGLE,
+  PROPERTY_MIN_RECT_AREA,
+  //! number of slots
+  PROPERTY_COUNT
+};
+
+//! Relative costs of evaluating an operator on a blob, see
+//! BlobOperator::cost()
+enum OperatorCost
+{
+  //! read from the bounding box or the id
+  COST_BOUNDS         = 1,
+  //! derived from the moments of the contours
+  COST_MOMENTS        = 2,
+  //! a scan of the points of the external contour
+  COST_CONTOUR_POINTS = 4,
+  //! a convex hull
+  COST_HULL           = 8,
+  //! a scan of the pixels of the blob
+  COST_PIXELS         = 16
+};
+
+//! Distance between two blobs used by ClusterBlobs()
+enum ClusterDistance
+{
+  //! distance between the bounding boxes, never more than the distance
+  //! between the contours
+  CLUSTER_BOUNDING_BOX = 0,
+  //! distance between the nearest pixels of the contours
+  CLUSTER_CONTOUR      = 1
+};
+
+//! What happened to a track between two frames, see BlobTracker::events()
+enum TrackEventType
+{
+  //! a blob that overlaps no track started a new track
+  TRACK_BIRTH,
+  //! a track that overlaps no blob ended
+  TRACK_DEATH,
+  //! a blob that overlaps a track continued by another blob started a new
+  //! track
+  TRACK_SPLIT,
+  //! a track that overlaps a blob continuing another track ended
+  TRACK_MERGE
+};
+
 //! Type of chain codes
 typedef ChainCode ChainCodeType;
 
-//! Type of list of chain codes
-typedef std::list<ChainCodeType> ChainCodeContainerType;
+//! Type of list of chain codes, packed 10 codes per 32 bit word
+typedef ChainCodeContainer ChainCodeContainerType;
 
 //! Type of list of points
 typedef std::vector<cv::Point> PointContainerType;
@@ -59,8 +170,9 @@ typedef std::vector<cv::Point> PointContainerType;
 //! Type of labelled images
 typedef unsigned int LabelType;
 
-//! Type of a list of contours
-typedef std::list<cv::Ptr<BlobContour> > ContourContainerType;
+//! Type of a list of contours. A vector, so a BlobArena can hand the storage
+//! of a destroyed blob to the next one
+typedef std::vector<cv::Ptr<BlobContour> > ContourContainerType;
 
 //! Blob vector definition
 typedef std::vector<cv::Ptr<Blob> > BlobContainerType;
@@ -0,0 +1,130 @@
+#include <cvblobs2/FeatureTable.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+FeatureTable::FeatureTable()
+    : mNames(),
+      mColumns()
+{}
+
+const std::vector<double>* FeatureTable::find(const std::string& name) const
+{
+  const std::size_t i = indexOf(name);
+  if (i == mColumns.size())
+  {
+    return NULL;
+  }
+  return &mColumns[i];
+}
+
+const std::vector<double>& FeatureTable::set(const std::string& name,
+                                             std::vector<double>& values)
+{
+  std::size_t i = indexOf(name);
+  if (i == mColumns.size())
+  {
+    mNames.push_back(name);
+    mColumns.push_back(std::vector<double>());
+  }
+  mColumns[i].swap(values);
+  values.clear();
+  return mColumns[i];
+}
+
+void FeatureTable::remove(const std::string& name)
+{
+  const std::size_t i = indexOf(name);
+  if (i == mColumns.size())
+  {
+    return;
+  }
+  mNames.erase(mNames.begin() + i);
+  mColumns.erase(mColumns.begin() + i);
+}
+
+void FeatureTable::clear()
+{
+  mNames.clear();
+  mColumns.clear();
+}
+
+void FeatureTable::compact(const std::vector<unsigned char>& keep)
+{
+  for (std::size_t c = 0; c < mColumns.size(); ++c)
+  {
+    std::vector<double>& column = mColumns[c];
+    std::size_t num_kept = 0;
+    for (std::size_t i = 0; i < column.size(); ++i)
+    {
+      if (keep[i])
+      {
+        column[num_kept++] = column[i];
+      }
+    }
+    column.resize(num_kept);
+  }
+}
+
+void FeatureTable::select(const std::vector<std::size_t>& rows,
+                          FeatureTable& dst) const
+{
+  FeatureTable selected;
+  selected.mNames = mNames;
+  selected.mColumns.resize(mColumns.size());
+  for (std::size_t c = 0; c < mColumns.size(); ++c)
+  {
+    const std::vector<double>& column = mColumns[c];
+    std::vector<double>& selected_column = selected.mColumns[c];
+    selected_column.resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+      selected_column[i] = column[rows[i]];
+    }
+  }
+  dst.swap(selected);
+}
+
+void FeatureTable::append(const FeatureTable& other)
+{
+  if (&other == this)
+  {
+    FeatureTable copy(other);
+    append(copy);
+    return;
+  }
+
+  std::size_t c = 0;
+  while (c < mColumns.size())
+  {
+    const std::vector<double>* p_other_column = other.find(mNames[c]);
+    if (p_other_column == NULL)
+    {
+      mNames.erase(mNames.begin() + c);
+      mColumns.erase(mColumns.begin() + c);
+      continue;
+    }
+    mColumns[c].reserve(mColumns[c].size() + p_other_column->size());
+    mColumns[c].insert(mColumns[c].end(),
+                       p_other_column->begin(),
+                       p_other_column->end());
+    ++c;
+  }
+}
+
+void FeatureTable::swap(FeatureTable& other)
+{
+  mNames.swap(other.mNames);
+  mColumns.swap(other.mColumns);
+}
+
+std::size_t FeatureTable::indexOf(const std::string& name) const
+{
+  std::size_t i = 0;
+  while (i < mNames.size() && mNames[i] != name)
+  {
+    ++i;
+  }
+  return i;
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,129 @@
+/**
+ * @brief Column store of the properties computed on a set of blobs.
+ */
+#ifndef _CVBLOBS2_FEATURETABLE_H_
+#define _CVBLOBS2_FEATURETABLE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class FeatureTable
+ * @brief Values of some properties of a sequence of blobs, one contiguous
+ * std::vector<double> per property indexed by the position of the blob.
+ *
+ * BlobResult keeps one to scan a property over all of its blobs without
+ * visiting every Blob. A column is named after the BlobOperator::key() of
+ * the operator that computed it. All columns have the same number of rows.
+ */
+class FeatureTable
+{
+ public:
+
+  FeatureTable();
+
+  /**
+   * @brief Returns the number of rows of the columns, 0 without columns
+   */
+  inline std::size_t numRows() const;
+
+  /**
+   * @brief Returns the number of columns
+   */
+  inline std::size_t numColumns() const;
+
+  /**
+   * @brief Returns the name of the column \p i
+   */
+  inline const std::string& name(std::size_t i) const;
+
+  /**
+   * @brief Returns the column \p i
+   */
+  inline const std::vector<double>& column(std::size_t i) const;
+
+  /**
+   * @brief Returns the column named \p name, NULL if there is none
+   */
+  const std::vector<double>* find(const std::string& name) const;
+
+  /**
+   * @brief Adds the column \p name, or replaces it if it exists, and takes
+   * the contents of \p values, leaving \p values empty
+   * @pre \p values has numRows() elements unless there are no columns
+   * @return the column
+   */
+  const std::vector<double>& set(const std::string& name,
+                                 std::vector<double>& values);
+
+  /**
+   * @brief Removes the column \p name if it exists
+   */
+  void remove(const std::string& name);
+
+  /**
+   * @brief Removes all of the columns
+   */
+  void clear();
+
+  /**
+   * @brief Keeps the rows i where \p keep[i] isn't 0, in order
+   * @pre \p keep has numRows() elements
+   */
+  void compact(const std::vector<unsigned char>& keep);
+
+  /**
+   * @brief Makes \p dst the rows \p rows of this table, in that order
+   */
+  void select(const std::vector<std::size_t>& rows, FeatureTable& dst) const;
+
+  /**
+   * @brief Appends the rows of \p other. A column that only one of the tables
+   * has can't be completed and is removed.
+   */
+  void append(const FeatureTable& other);
+
+  /**
+   * @brief Swaps the columns of this table with the ones of \p other
+   */
+  void swap(FeatureTable& other);
+
+ private:
+
+  //! index of the column \p name, numColumns() if there is none
+  std::size_t indexOf(const std::string& name) const;
+
+  //! names of the columns
+  std::vector<std::string> mNames;
+  //! values of the columns, mColumns[i] is named mNames[i]
+  std::vector<std::vector<double> > mColumns;
+};
+
+inline std::size_t FeatureTable::numRows() const
+{
+  return mColumns.empty() ? 0 : mColumns.front().size();
+}
+
+inline std::size_t FeatureTable::numColumns() const
+{
+  return mColumns.size();
+}
+
+inline const std::string& FeatureTable::name(std::size_t i) const
+{
+  return mNames[i];
+}
+
+inline const std::vector<double>& FeatureTable::column(std::size_t i) const
+{
+  return mColumns[i];
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_FEATURETABLE_H_
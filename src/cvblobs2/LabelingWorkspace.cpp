@@ -0,0 +1,438 @@
+#include <cvblobs2/LabelingWorkspace.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobArena.h>
+#include <cvblobs2/BlobContour.h>
+#include <cvblobs2/ScanlineSkip.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! Foreground test of a background color, compared in the pixel type
+template <typename PixelType>
+struct NotBackground
+{
+  explicit NotBackground(double backgroundColor)
+      : mBackground(cv::saturate_cast<PixelType>(backgroundColor))
+  {}
+
+  bool operator()(PixelType pixel) const
+  {
+    return pixel != mBackground;
+  }
+
+  PixelType mBackground;
+};
+
+//! Foreground test of a FilterCondition. \p condition is a template
+//! argument so the switch is resolved at compile time.
+template <FilterCondition condition>
+struct PassesCondition
+{
+  PassesCondition(double lowLimit, double highLimit)
+      : mLowLimit(lowLimit),
+        mHighLimit(highLimit)
+  {}
+
+  template <typename PixelType>
+  bool operator()(PixelType pixel) const
+  {
+    const double value = static_cast<double>(pixel);
+    switch (condition)
+    {
+      case CONDITION_EQUAL:
+        return value == mLowLimit;
+      case CONDITION_NOT_EQUAL:
+        return value != mLowLimit;
+      case CONDITION_GREATER:
+        return value > mLowLimit;
+      case CONDITION_LESS:
+        return value < mLowLimit;
+      case CONDITION_GREATER_OR_EQUAL:
+        return value >= mLowLimit;
+      case CONDITION_LESS_OR_EQUAL:
+        return value <= mLowLimit;
+      case CONDITION_INSIDE:
+        return value >= mLowLimit && value <= mHighLimit;
+      case CONDITION_OUTSIDE:
+        return value < mLowLimit || value > mHighLimit;
+    }
+    return false;
+  }
+
+  double mLowLimit;
+  double mHighLimit;
+};
+
+/**
+ * @brief Writes rows [rowBegin, rowEnd) of the foreground map for an image of
+ * \p PixelType pixels. The mask test is compiled out when \p bHasMask is
+ * false and \p isForeground is inlined, so every combination is a branch free
+ * loop.
+ */
+template <typename PixelType, bool bHasMask, typename Predicate>
+void binarizeRows(const cv::Mat& inputImage,
+                  const cv::Mat& maskImage,
+                  const Predicate& isForeground,
+                  int rowBegin,
+                  int rowEnd,
+                  cv::Mat& foregroundMap)
+{
+  const int width = inputImage.cols;
+  for (int row = rowBegin; row < rowEnd; ++row)
+  {
+    const PixelType* p_input_row = inputImage.ptr<PixelType>(row);
+    const unsigned char* p_mask_row = bHasMask ? maskImage.ptr(row) : NULL;
+    unsigned char* p_foreground_row = foregroundMap.ptr(row + 1) + 1;
+
+    // the contour tracing may have marked the border as visited
+    p_foreground_row[-1] = 0;
+    p_foreground_row[width] = 0;
+
+    for (int col = 0; col < width; ++col)
+    {
+      bool b_foreground = isForeground(p_input_row[col]);
+      if (bHasMask)
+      {
+        b_foreground = b_foreground && (p_mask_row[col] != 0);
+      }
+      p_foreground_row[col] =
+          b_foreground ? LabelingWorkspace::MAP_FOREGROUND : 0;
+    }
+  }
+}
+
+template <typename PixelType, typename Predicate>
+void binarizeRows(const cv::Mat& inputImage,
+                  const cv::Mat& maskImage,
+                  const Predicate& isForeground,
+                  int rowBegin,
+                  int rowEnd,
+                  cv::Mat& foregroundMap)
+{
+  if (maskImage.empty())
+  {
+    binarizeRows<PixelType, false>(inputImage,
+                                   maskImage,
+                                   isForeground,
+                                   rowBegin,
+                                   rowEnd,
+                                   foregroundMap);
+  }
+  else
+  {
+    binarizeRows<PixelType, true>(inputImage,
+                                  maskImage,
+                                  isForeground,
+                                  rowBegin,
+                                  rowEnd,
+                                  foregroundMap);
+  }
+}
+
+/**
+ * @brief Writes rows [rowBegin, rowEnd) of the foreground map where the
+ * pixels differ from \p backgroundColor
+ */
+template <typename PixelType>
+void binarizeBackgroundRows(const cv::Mat& inputImage,
+                            const cv::Mat& maskImage,
+                            double backgroundColor,
+                            int rowBegin,
+                            int rowEnd,
+                            cv::Mat& foregroundMap)
+{
+  binarizeRows<PixelType>(inputImage,
+                          maskImage,
+                          NotBackground<PixelType>(backgroundColor),
+                          rowBegin,
+                          rowEnd,
+                          foregroundMap);
+}
+
+/**
+ * @brief 8 bit version: the input and mask rows are searched for the ends of
+ * the runs with findForegroundColumn() and findBackgroundColumn(), 16 or 32
+ * pixels at a time, and the map is written one run or gap at a time. A
+ * mostly background frame is read and written at the speed of memset.
+ */
+template <>
+void binarizeBackgroundRows<unsigned char>(const cv::Mat& inputImage,
+                                           const cv::Mat& maskImage,
+                                           double backgroundColor,
+                                           int rowBegin,
+                                           int rowEnd,
+                                           cv::Mat& foregroundMap)
+{
+  const unsigned char background =
+      cv::saturate_cast<unsigned char>(backgroundColor);
+  const int width = inputImage.cols;
+  for (int row = rowBegin; row < rowEnd; ++row)
+  {
+    const unsigned char* p_input_row = inputImage.ptr(row);
+    const unsigned char* p_mask_row =
+        maskImage.empty() ? NULL : maskImage.ptr(row);
+    unsigned char* p_foreground_row = foregroundMap.ptr(row + 1) + 1;
+
+    // the contour tracing may have marked the border as visited
+    p_foreground_row[-1] = 0;
+    p_foreground_row[width] = 0;
+
+    int col = 0;
+    while (col < width)
+    {
+      const int run_start = findForegroundColumn(p_input_row,
+                                                 p_mask_row,
+                                                 col,
+                                                 width,
+                                                 background);
+      std::memset(p_foreground_row + col, 0, run_start - col);
+      if (run_start == width)
+      {
+        break;
+      }
+      col = findBackgroundColumn(p_input_row,
+                                 p_mask_row,
+                                 run_start,
+                                 width,
+                                 background);
+      std::memset(p_foreground_row + run_start,
+                  LabelingWorkspace::MAP_FOREGROUND,
+                  col - run_start);
+    }
+  }
+}
+
+template <typename PixelType>
+void binarizeRows(const cv::Mat& inputImage,
+                  const cv::Mat& maskImage,
+                  const PixelCondition& foreground,
+                  int rowBegin,
+                  int rowEnd,
+                  cv::Mat& foregroundMap)
+{
+  const double low_limit = foreground.lowLimit();
+  const double high_limit = foreground.highLimit();
+  if (foreground.isBackgroundColor())
+  {
+    binarizeBackgroundRows<PixelType>(inputImage,
+                                      maskImage,
+                                      low_limit,
+                                      rowBegin,
+                                      rowEnd,
+                                      foregroundMap);
+    return;
+  }
+
+  switch (foreground.condition())
+  {
+    case CONDITION_EQUAL:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_EQUAL>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_NOT_EQUAL:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_NOT_EQUAL>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_GREATER:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_GREATER>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_LESS:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_LESS>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_GREATER_OR_EQUAL:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_GREATER_OR_EQUAL>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_LESS_OR_EQUAL:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_LESS_OR_EQUAL>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_INSIDE:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_INSIDE>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+    case CONDITION_OUTSIDE:
+      binarizeRows<PixelType>(
+          inputImage, maskImage,
+          PassesCondition<CONDITION_OUTSIDE>(low_limit, high_limit),
+          rowBegin, rowEnd, foregroundMap);
+      break;
+  }
+}
+
+} // end anonymous namespace
+
+LabelingWorkspace::LabelingWorkspace()
+    : mLabels(),
+      mForegroundMap(),
+      mDirtyRowBegin(0),
+      mDirtyRowEnd(0),
+      mpArena(NULL)
+{
+  chainCodeOffsets(0, mNeighbourOffsets);
+  chainCodeOffsets(0, mLabelOffsets);
+}
+
+void LabelingWorkspace::prepare(const cv::Size& imageSize)
+{
+  if (imageSize != size())
+  {
+    // the buffers are used as plain row major arrays, cv::Mat::create()
+    // always allocates them continuous
+    mLabels.create(imageSize, CV_32SC1);
+    mForegroundMap.create(imageSize.height + 2, imageSize.width + 2, CV_8UC1);
+    mLabels.setTo(cv::Scalar(0));
+    mForegroundMap.setTo(cv::Scalar(0));
+
+    chainCodeOffsets(foregroundStep(), mNeighbourOffsets);
+    chainCodeOffsets(imageSize.width, mLabelOffsets);
+  }
+  else if (mLabels.refcount != NULL && *mLabels.refcount > 1)
+  {
+    // the label image of the previous labeling is still used by the caller,
+    // leave it to them and label into a new buffer
+    mLabels.release();
+    mLabels.create(imageSize, CV_32SC1);
+    mLabels.setTo(cv::Scalar(0));
+  }
+  else if (mDirtyRowBegin < mDirtyRowEnd)
+  {
+    mLabels.rowRange(mDirtyRowBegin, mDirtyRowEnd).setTo(cv::Scalar(0));
+  }
+  mDirtyRowBegin = 0;
+  mDirtyRowEnd = 0;
+}
+
+bool LabelingWorkspace::isSupportedType(int type)
+{
+  return type == CV_8UC1 ||
+      type == CV_16UC1 ||
+      type == CV_32FC1;
+}
+
+void LabelingWorkspace::buildForegroundMap(const cv::Mat& inputImage,
+                                           const cv::Mat& maskImage,
+                                           const PixelCondition& foreground,
+                                           int rowBegin,
+                                           int rowEnd)
+{
+  // the contour tracing may have marked the border as visited
+  if (rowBegin == 0)
+  {
+    std::memset(mForegroundMap.ptr(0), 0, mForegroundMap.cols);
+  }
+  if (rowEnd == inputImage.rows)
+  {
+    std::memset(mForegroundMap.ptr(rowEnd + 1), 0, mForegroundMap.cols);
+  }
+
+  switch (inputImage.type())
+  {
+    case CV_8UC1:
+      binarizeRows<unsigned char>(inputImage,
+                                  maskImage,
+                                  foreground,
+                                  rowBegin,
+                                  rowEnd,
+                                  mForegroundMap);
+      break;
+    case CV_16UC1:
+      binarizeRows<unsigned short>(inputImage,
+                                   maskImage,
+                                   foreground,
+                                   rowBegin,
+                                   rowEnd,
+                                   mForegroundMap);
+      break;
+    case CV_32FC1:
+      binarizeRows<float>(inputImage,
+                          maskImage,
+                          foreground,
+                          rowBegin,
+                          rowEnd,
+                          mForegroundMap);
+      break;
+    default:
+      break;
+  }
+}
+
+void LabelingWorkspace::markDirty(int rowBegin, int rowEnd)
+{
+  rowBegin = std::max(rowBegin, 0);
+  rowEnd = std::min(rowEnd, mLabels.rows);
+  if (rowBegin >= rowEnd)
+  {
+    return;
+  }
+
+  if (mDirtyRowBegin < mDirtyRowEnd)
+  {
+    mDirtyRowBegin = std::min(mDirtyRowBegin, rowBegin);
+    mDirtyRowEnd = std::max(mDirtyRowEnd, rowEnd);
+  }
+  else
+  {
+    mDirtyRowBegin = rowBegin;
+    mDirtyRowEnd = rowEnd;
+  }
+}
+
+void LabelingWorkspace::release()
+{
+  mLabels.release();
+  mForegroundMap.release();
+  chainCodeOffsets(0, mNeighbourOffsets);
+  chainCodeOffsets(0, mLabelOffsets);
+  mDirtyRowBegin = 0;
+  mDirtyRowEnd = 0;
+}
+
+void LabelingWorkspace::setArena(BlobArena* pArena)
+{
+  mpArena = pArena;
+}
+
+cv::Ptr<Blob> LabelingWorkspace::createBlob(LabelType id,
+                                            const cv::Point& startPoint,
+                                            const cv::Size& originalImageSize)
+{
+  if (mpArena != NULL)
+  {
+    return mpArena->createBlob(id, startPoint, originalImageSize);
+  }
+  return new Blob(id, startPoint, originalImageSize);
+}
+
+cv::Ptr<BlobContour> LabelingWorkspace::createContour(
+    const cv::Point& startPoint)
+{
+  if (mpArena != NULL)
+  {
+    return mpArena->createContour(startPoint);
+  }
+  return new BlobContour(startPoint);
+}
+
+CVBLOBS_END_NAMESPACE
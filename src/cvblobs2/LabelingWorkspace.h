@@ -0,0 +1,243 @@
+/**
+ * @brief Scratch buffers of the component labeling that can be kept between
+ * frames.
+ */
+#ifndef _CVBLOBS2_LABELINGWORKSPACE_H_
+#define _CVBLOBS2_LABELINGWORKSPACE_H_
+
+#include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/PixelCondition.h>
+#include <opencv2/core/core.hpp>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class LabelingWorkspace
+ * @brief Owns the foreground map and the label buffer used by
+ * ComponentLabeling().
+ *
+ * Keep one workspace per thread and pass it to every ComponentLabeling()
+ * call. The buffers are only reallocated when the image size changes and only
+ * the rows written by the previous labeling are cleared, so labeling frames
+ * of a constant size doesn't allocate and doesn't clear the whole buffers.
+ * @code
+   cvblobs::LabelingWorkspace workspace;
+   for (;;)
+   {
+     capture >> frame;
+     cvblobs::BlobContainerType blobs;
+     cvblobs::ComponentLabeling(frame, cv::Mat(), 0, blobs, workspace);
+   }
+   @endcode
+ *
+ * The foreground map has a 1 pixel border of background around the image, so
+ * the 8 neighbours of any image pixel can be read without bounds checks using
+ * neighbourOffsets(). Every byte of the map is a set of MapFlags, the
+ * contour tracing marks the background pixels it visits in the map itself
+ * so no other buffer is needed for them.
+ */
+class LabelingWorkspace
+{
+ public:
+
+  //! Bits of a foreground map pixel
+  enum MapFlags
+  {
+    //! the pixel is foreground
+    MAP_FOREGROUND = 0x01,
+    //! the background pixel has been visited by the contour tracing
+    MAP_VISITED    = 0x02
+  };
+
+  LabelingWorkspace();
+
+  /**
+   * @brief Makes the buffers \p imageSize big and all zeros.
+   * Reallocates only if \p imageSize differs from size(), otherwise only the
+   * dirty rows are cleared. A new label buffer is also allocated while a
+   * label image returned by labelImage() still references the current one.
+   * The foreground map isn't cleared, it must be rebuilt with
+   * buildForegroundMap() for every image.
+   */
+  void prepare(const cv::Size& imageSize);
+
+  /**
+   * @brief Returns true for the image types the foreground map can be built
+   * from: CV_8UC1, CV_16UC1 and CV_32FC1
+   */
+  static bool isSupportedType(int type);
+
+  /**
+   * @brief Writes rows [rowBegin, rowEnd) of the foreground map:
+   * MAP_FOREGROUND where \p inputImage passes \p foreground and
+   * \p maskImage, if not empty, isn't 0, 0 elsewhere. The border next to the
+   * rows is reset to 0.
+   * Different row ranges can be built on different threads.
+   * @pre prepare() has been called with the size of \p inputImage
+   * @param inputImage image of a type accepted by isSupportedType()
+   * @param maskImage empty or CV_8UC1
+   */
+  void buildForegroundMap(const cv::Mat& inputImage,
+                          const cv::Mat& maskImage,
+                          const PixelCondition& foreground,
+                          int rowBegin,
+                          int rowEnd);
+
+  /**
+   * @brief Records that rows [rowBegin, rowEnd) of the label buffer have been
+   * written and must be cleared before the next labeling. Rows outside of
+   * the buffer are ignored.
+   */
+  void markDirty(int rowBegin, int rowEnd);
+
+  /**
+   * @brief Frees the buffers. The arena stays attached.
+   */
+  void release();
+
+  /**
+   * @brief Makes the labeling allocate its blobs and contours from
+   * \p pArena, or from the heap if \p pArena is NULL (the default).
+   * The workspace doesn't own the arena.
+   */
+  void setArena(BlobArena* pArena);
+
+  /**
+   * @brief Returns the arena the blobs are allocated from, NULL for the heap
+   */
+  inline BlobArena* arena() const;
+
+  /**
+   * @brief Creates a blob from the arena or the heap, see Blob::Blob()
+   */
+  cv::Ptr<Blob> createBlob(LabelType id,
+                           const cv::Point& startPoint,
+                           const cv::Size& originalImageSize);
+
+  /**
+   * @brief Creates a contour from the arena or the heap, see
+   * BlobContour::BlobContour()
+   */
+  cv::Ptr<BlobContour> createContour(const cv::Point& startPoint);
+
+  /**
+   * @brief Returns the size of the buffers
+   */
+  inline cv::Size size() const;
+
+  /**
+   * @brief Returns the row major label buffer
+   */
+  inline LabelType* labels();
+
+  /**
+   * @brief Returns the label buffer as a CV_32SC1 image, without copying it.
+   * The workspace won't write to a buffer that is still referenced by a
+   * returned image, so the image stays valid after the next labeling. Release
+   * it before the next labeling to let the workspace reuse the buffer.
+   */
+  inline cv::Mat labelImage() const;
+
+  /**
+   * @brief Returns the padded foreground map at pixel (0, 0), rows are
+   * foregroundStep() elements apart
+   */
+  inline unsigned char* foregroundMap();
+  inline const unsigned char* foregroundMap() const;
+
+  /**
+   * @brief Returns the row \p row of the padded foreground map at pixel (0, row)
+   */
+  inline const unsigned char* foregroundRow(int row) const;
+
+  /**
+   * @brief Returns the distance in elements between two rows of the padded
+   * foreground map
+   */
+  inline int foregroundStep() const;
+
+  /**
+   * @brief Returns the offsets of the 8 neighbours in the padded foreground
+   * map, indexed by ChainCode
+   */
+  inline const int* neighbourOffsets() const;
+
+  /**
+   * @brief Returns the offsets of the 8 neighbours in the label buffer,
+   * indexed by ChainCode
+   */
+  inline const int* labelOffsets() const;
+
+ private:
+
+  //! label of every pixel (CV_32SC1)
+  cv::Mat mLabels;
+  //! MapFlags of every pixel with a 1 pixel border (CV_8UC1)
+  cv::Mat mForegroundMap;
+
+  //! neighbour offsets in mForegroundMap
+  int mNeighbourOffsets[CHAIN_CODE_MAX];
+  //! neighbour offsets in mLabels
+  int mLabelOffsets[CHAIN_CODE_MAX];
+
+  //! rows [mDirtyRowBegin, mDirtyRowEnd) of mLabels may be non zero
+  int mDirtyRowBegin;
+  int mDirtyRowEnd;
+
+  //! arena of the blobs, NULL to allocate them from the heap
+  BlobArena* mpArena;
+};
+
+inline cv::Size LabelingWorkspace::size() const
+{
+  return mLabels.size();
+}
+
+inline LabelType* LabelingWorkspace::labels()
+{
+  return reinterpret_cast<LabelType*>(mLabels.data);
+}
+
+inline cv::Mat LabelingWorkspace::labelImage() const
+{
+  return mLabels;
+}
+
+inline BlobArena* LabelingWorkspace::arena() const
+{
+  return mpArena;
+}
+
+inline unsigned char* LabelingWorkspace::foregroundMap()
+{
+  return mForegroundMap.data + mForegroundMap.step + 1;
+}
+
+inline const unsigned char* LabelingWorkspace::foregroundMap() const
+{
+  return mForegroundMap.data + mForegroundMap.step + 1;
+}
+
+inline const unsigned char* LabelingWorkspace::foregroundRow(int row) const
+{
+  return mForegroundMap.ptr(row + 1) + 1;
+}
+
+inline int LabelingWorkspace::foregroundStep() const
+{
+  return static_cast<int>(mForegroundMap.step);
+}
+
+inline const int* LabelingWorkspace::neighbourOffsets() const
+{
+  return mNeighbourOffsets;
+}
+
+inline const int* LabelingWorkspace::labelOffsets() const
+{
+  return mLabelOffsets;
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_LABELINGWORKSPACE_H_
@@ -0,0 +1,123 @@
+/**
+ * @brief Test deciding which pixels of a labeled image are foreground.
+ */
+#ifndef _CVBLOBS2_PIXELCONDITION_H_
+#define _CVBLOBS2_PIXELCONDITION_H_
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @class PixelCondition
+ * @brief Selects the foreground pixels of the image given to
+ * ComponentLabeling().
+ *
+ * Either the pixels that differ from a background color, which is how
+ * ComponentLabeling() has always worked, or the pixels whose value passes a
+ * FilterCondition. The second form labels a grayscale image directly instead
+ * of thresholding it into a binary image first:
+ * @code
+   // same blobs as cv::threshold(gray, binary, 100, 255, cv::THRESH_BINARY)
+   // followed by labeling binary with a background of 0
+   cvblobs::ComponentLabeling(gray,
+                              cv::Mat(),
+                              cvblobs::PixelCondition(cvblobs::CONDITION_GREATER,
+                                                      100),
+                              blobs);
+   // same blobs as cv::inRange(gray, 50, 200, binary)
+   cvblobs::ComponentLabeling(gray,
+                              cv::Mat(),
+                              cvblobs::PixelCondition(cvblobs::CONDITION_INSIDE,
+                                                      50, 200),
+                              blobs);
+   @endcode
+ * The condition is evaluated while the labeling builds its foreground map, so
+ * no intermediate binary image is written or read.
+ */
+class PixelCondition
+{
+ public:
+
+  /**
+   * @brief Pixels different from \p backgroundColor are foreground.
+   * \p backgroundColor is converted to the pixel type of the image with
+   * cv::saturate_cast. Not explicit so a background color can be passed
+   * where a PixelCondition is expected.
+   */
+  inline PixelCondition(double backgroundColor);
+
+  /**
+   * @brief Pixels whose value passes \p condition are foreground. The pixel
+   * values are compared to the limits as doubles, like BlobResult::filter()
+   * compares the results of an operator.
+   * @param highLimit only used by CONDITION_INSIDE and CONDITION_OUTSIDE
+   */
+  inline PixelCondition(FilterCondition condition,
+                        double lowLimit,
+                        double highLimit = 0);
+
+  /**
+   * @brief Returns true if the condition was built from a background color
+   */
+  inline bool isBackgroundColor() const;
+
+  /**
+   * @brief Returns the condition, CONDITION_NOT_EQUAL for a background color
+   */
+  inline FilterCondition condition() const;
+
+  /**
+   * @brief Returns the low limit, the background color for a background color
+   */
+  inline double lowLimit() const;
+
+  inline double highLimit() const;
+
+ private:
+
+  bool mbBackgroundColor;
+  FilterCondition mCondition;
+  double mLowLimit;
+  double mHighLimit;
+};
+
+inline PixelCondition::PixelCondition(double backgroundColor)
+    : mbBackgroundColor(true),
+      mCondition(CONDITION_NOT_EQUAL),
+      mLowLimit(backgroundColor),
+      mHighLimit(0)
+{}
+
+inline PixelCondition::PixelCondition(FilterCondition condition,
+                                      double lowLimit,
+                                      double highLimit /*= 0*/)
+    : mbBackgroundColor(false),
+      mCondition(condition),
+      mLowLimit(lowLimit),
+      mHighLimit(highLimit)
+{}
+
+inline bool PixelCondition::isBackgroundColor() const
+{
+  return mbBackgroundColor;
+}
+
+inline FilterCondition PixelCondition::condition() const
+{
+  return mCondition;
+}
+
+inline double PixelCondition::lowLimit() const
+{
+  return mLowLimit;
+}
+
+inline double PixelCondition::highLimit() const
+{
+  return mHighLimit;
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_PIXELCONDITION_H_
@@ -0,0 +1,726 @@
+#include <cvblobs2/RunLengthLabeling.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include <cvblobs2/Blob.h>
+#include <cvblobs2/BlobContour.h>
+#include <cvblobs2/ComponentLabeling.h>
+#include <cvblobs2/LabelingWorkspace.h>
+#include <cvblobs2/ScanlineSkip.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! bands are never made smaller than this many rows
+const int MIN_BAND_ROWS = 32;
+//! number of bands per thread, to balance the load between threads
+const int BANDS_PER_THREAD = 4;
+
+/**
+ * @brief A horizontal span of pixels [start, end) on a single image row
+ */
+struct PixelRun
+{
+  int row;
+  int start;
+  int end;
+};
+
+/**
+ * @brief Disjoint sets of runs (union-find).
+ * Runs are added in raster order and the root of every set is always the
+ * smallest index in that set, ie the first run of the set in raster order.
+ */
+class RunSets
+{
+ public:
+
+  //! Adds a new set containing only the next index and returns that index
+  inline int add()
+  {
+    const int index = static_cast<int>(mParent.size());
+    mParent.push_back(index);
+    return index;
+  }
+
+  //! Appends the sets of \p other, its indices are shifted by size()
+  inline void append(const RunSets& other)
+  {
+    const int offset = static_cast<int>(mParent.size());
+    mParent.reserve(mParent.size() + other.mParent.size());
+    for (std::size_t i = 0; i < other.mParent.size(); ++i)
+    {
+      mParent.push_back(other.mParent[i] + offset);
+    }
+  }
+
+  //! Exchanges the sets of \p other and this
+  inline void swap(RunSets& other)
+  {
+    mParent.swap(other.mParent);
+  }
+
+  //! Returns the root of the set containing \p index (with path halving)
+  inline int find(int index)
+  {
+    while (mParent[index] != index)
+    {
+      mParent[index] = mParent[mParent[index]];
+      index = mParent[index];
+    }
+    return index;
+  }
+
+  //! Joins the sets containing \p lhs and \p rhs, the smallest root wins
+  inline void merge(int lhs, int rhs)
+  {
+    lhs = find(lhs);
+    rhs = find(rhs);
+    if (lhs < rhs)
+    {
+      mParent[rhs] = lhs;
+    }
+    else if (rhs < lhs)
+    {
+      mParent[lhs] = rhs;
+    }
+  }
+
+ private:
+
+  //! parent index of every element
+  std::vector<int> mParent;
+};
+
+/**
+ * @brief Runs and background gaps of a horizontal band of rows. Indices in
+ * the row tables are local to the band.
+ */
+struct RunBand
+{
+  //! runs of foreground pixels in raster order, grouped into components
+  std::vector<PixelRun> runs;
+  RunSets run_sets;
+  //! index of the first run of every row of the band
+  std::vector<int> row_first_run;
+
+  //! runs of background pixels in raster order, grouped into 4-connected
+  //! regions
+  std::vector<PixelRun> gaps;
+  RunSets gap_sets;
+  //! index of the first gap of every row of the band
+  std::vector<int> row_first_gap;
+  //! non zero for the gaps that touch the image border, they aren't holes
+  std::vector<char> gap_on_border;
+};
+
+/**
+ * @brief Joins the spans of a row, [aboveEnd, end) in \p spans, with the
+ * spans of the row above it, [aboveBegin, aboveEnd).
+ * @param reach 1 to join diagonal neighbours (8-connectivity), 0 otherwise
+ * (4-connectivity)
+ */
+void mergeRows(const std::vector<PixelRun>& spans,
+               int aboveBegin,
+               int aboveEnd,
+               int end,
+               int reach,
+               RunSets& sets)
+{
+  int above_span = aboveBegin;
+  for (int span = aboveEnd; span < end; ++span)
+  {
+    // spans above that end before this one starts can't touch this or any
+    // later span of the row
+    while (above_span < aboveEnd &&
+           spans[above_span].end + reach <= spans[span].start)
+    {
+      ++above_span;
+    }
+    for (int above = above_span;
+         above < aboveEnd && spans[above].start < spans[span].end + reach;
+         ++above)
+    {
+      sets.merge(above, span);
+    }
+  }
+}
+
+/**
+ * @brief Builds the rows [rowBegin, rowEnd) of the foreground map of
+ * \p workspace, scans them into \p band and joins the runs and gaps of every
+ * row with the ones of the row above it, inside of the band.
+ */
+void scanBand(const cv::Mat& inputImage,
+              const cv::Mat& maskImage,
+              const PixelCondition& foreground,
+              int rowBegin,
+              int rowEnd,
+              LabelingWorkspace& workspace,
+              RunBand& band)
+{
+  const cv::Size image_size = inputImage.size();
+
+  workspace.buildForegroundMap(inputImage,
+                               maskImage,
+                               foreground,
+                               rowBegin,
+                               rowEnd);
+
+  band.row_first_run.resize(rowEnd - rowBegin);
+  band.row_first_gap.resize(rowEnd - rowBegin);
+
+  for (int row = rowBegin; row < rowEnd; ++row)
+  {
+    const unsigned char* p_foreground_row = workspace.foregroundRow(row);
+
+    const int first_run = static_cast<int>(band.runs.size());
+    const int first_gap = static_cast<int>(band.gaps.size());
+    band.row_first_run[row - rowBegin] = first_run;
+    band.row_first_gap[row - rowBegin] = first_gap;
+
+    int col = 0;
+    while (col < image_size.width)
+    {
+      // the background up to the next run is a gap
+      PixelRun gap;
+      gap.row = row;
+      gap.start = col;
+      col = findForegroundColumn(p_foreground_row,
+                                 NULL,
+                                 col,
+                                 image_size.width,
+                                 0);
+      gap.end = col;
+      if (gap.end > gap.start)
+      {
+        band.gaps.push_back(gap);
+        band.gap_sets.add();
+        // background touching the image border is not a hole
+        band.gap_on_border.push_back(row == 0 ||
+                                     row == image_size.height - 1 ||
+                                     gap.start == 0 ||
+                                     gap.end == image_size.width);
+      }
+      if (col == image_size.width)
+      {
+        break;
+      }
+
+      PixelRun run;
+      run.row = row;
+      run.start = col;
+      col = findBackgroundColumn(p_foreground_row,
+                                 NULL,
+                                 col,
+                                 image_size.width,
+                                 0);
+      run.end = col;
+      band.runs.push_back(run);
+      band.run_sets.add();
+    } // end while columns left in row
+
+    if (row > rowBegin)
+    {
+      mergeRows(band.runs,
+                band.row_first_run[row - rowBegin - 1],
+                first_run,
+                static_cast<int>(band.runs.size()),
+                1, // 8-connected foreground
+                band.run_sets);
+      mergeRows(band.gaps,
+                band.row_first_gap[row - rowBegin - 1],
+                first_gap,
+                static_cast<int>(band.gaps.size()),
+                0, // 4-connected background
+                band.gap_sets);
+    }
+  } // end for each row
+}
+
+/**
+ * @brief Scans a range of bands, every band is independent of the others
+ */
+class BandScanner : public cv::ParallelLoopBody
+{
+ public:
+
+  BandScanner(const cv::Mat& inputImage,
+              const cv::Mat& maskImage,
+              const PixelCondition& foreground,
+              int bandRows,
+              LabelingWorkspace& workspace,
+              std::vector<RunBand>& bands)
+      : mInputImage(inputImage),
+        mMaskImage(maskImage),
+        mForeground(foreground),
+        mBandRows(bandRows),
+        mWorkspace(workspace),
+        mBands(bands)
+  {}
+
+  virtual void operator()(const cv::Range& range) const
+  {
+    for (int i = range.start; i < range.end; ++i)
+    {
+      const int row_begin = i * mBandRows;
+      const int row_end = std::min(row_begin + mBandRows, mInputImage.rows);
+      scanBand(mInputImage,
+               mMaskImage,
+               mForeground,
+               row_begin,
+               row_end,
+               mWorkspace,
+               mBands[i]);
+    }
+  }
+
+ private:
+
+  const cv::Mat& mInputImage;
+  const cv::Mat& mMaskImage;
+  PixelCondition mForeground;
+  int mBandRows;
+  LabelingWorkspace& mWorkspace;
+  std::vector<RunBand>& mBands;
+};
+
+/**
+ * @brief Paints the runs of a range of bands into the label buffer, the bands
+ * don't share any row
+ */
+class RunPainter : public cv::ParallelLoopBody
+{
+ public:
+
+  RunPainter(const std::vector<PixelRun>& runs,
+             const std::vector<LabelType>& runLabels,
+             const std::vector<int>& rowFirstRun,
+             int bandRows,
+             LabelingWorkspace& workspace)
+      : mRuns(runs),
+        mRunLabels(runLabels),
+        mRowFirstRun(rowFirstRun),
+        mBandRows(bandRows),
+        mWorkspace(workspace)
+  {}
+
+  virtual void operator()(const cv::Range& range) const
+  {
+    const cv::Size image_size = mWorkspace.size();
+    LabelType* p_labels = mWorkspace.labels();
+    const int row_begin = range.start * mBandRows;
+    const int row_end = std::min(range.end * mBandRows, image_size.height);
+    for (int i = mRowFirstRun[row_begin]; i < mRowFirstRun[row_end]; ++i)
+    {
+      const PixelRun& run = mRuns[i];
+      LabelType* p_labels_row = p_labels + run.row * image_size.width;
+      std::fill(p_labels_row + run.start,
+                p_labels_row + run.end,
+                mRunLabels[i]);
+    }
+  }
+
+ private:
+
+  const std::vector<PixelRun>& mRuns;
+  const std::vector<LabelType>& mRunLabels;
+  const std::vector<int>& mRowFirstRun;
+  int mBandRows;
+  LabelingWorkspace& mWorkspace;
+};
+
+/**
+ * @brief A contour to trace, once all of the components are known
+ */
+struct ContourJob
+{
+  cv::Point start;
+  LabelType label;
+  bool b_internal;
+  cv::Ptr<BlobContour> contour;
+};
+
+/**
+ * @brief Traces a range of contours, every contour is independent of the
+ * others because no label or visited image is written.
+ */
+class ContourTracer : public cv::ParallelLoopBody
+{
+ public:
+
+  ContourTracer(LabelingWorkspace& workspace,
+                const std::vector<ContourJob>& jobs)
+      : mWorkspace(workspace),
+        mJobs(jobs)
+  {}
+
+  virtual void operator()(const cv::Range& range) const
+  {
+    for (int i = range.start; i < range.end; ++i)
+    {
+      const ContourJob& job = mJobs[i];
+      contourTracing(mWorkspace,
+                     job.start,
+                     NULL,  // no label image
+                     false, // workspace is only read
+                     job.label,
+                     job.b_internal,
+                     job.contour);
+    }
+  }
+
+ private:
+
+  LabelingWorkspace& mWorkspace;
+  const std::vector<ContourJob>& mJobs;
+};
+
+/**
+ * @brief Returns the index of the run in [firstRun, lastRun) of \p runs that
+ * contains column \p col. The runs must all be on the same row.
+ */
+int findRunContaining(const std::vector<PixelRun>& runs,
+                      int firstRun,
+                      int lastRun,
+                      int col)
+{
+  // runs on a row are sorted and disjoint, binary search them
+  while (lastRun - firstRun > 1)
+  {
+    const int middle = firstRun + (lastRun - firstRun) / 2;
+    if (runs[middle].start <= col)
+    {
+      firstRun = middle;
+    }
+    else
+    {
+      lastRun = middle;
+    }
+  }
+  return firstRun;
+}
+
+/**
+ * @brief Labels \p inputImage, the label buffer is painted and handed to
+ * \p pLabelImage when it isn't NULL
+ */
+bool labelRuns(const cv::Mat& inputImage,
+               const cv::Mat& maskImage,
+               const PixelCondition& foreground,
+               BlobContainerType& blobs,
+               LabelingWorkspace& workspace,
+               cv::Mat* pLabelImage,
+               bool bParallel,
+               bool bAccumulateMoments)
+{
+  if (inputImage.empty() ||
+      !LabelingWorkspace::isSupportedType(inputImage.type()))
+  {
+    return false;
+  }
+  if (!maskImage.empty() &&
+      (maskImage.size() != inputImage.size() || maskImage.type() != CV_8UC1))
+  {
+    return false;
+  }
+
+  const cv::Size image_size = inputImage.size();
+  // a label image of the previous frame would keep the workspace from
+  // reusing its buffer
+  if (pLabelImage != NULL)
+  {
+    pLabelImage->release();
+  }
+  workspace.prepare(image_size);
+
+  int num_bands = 1;
+  if (bParallel)
+  {
+    num_bands = std::min(cv::getNumThreads() * BANDS_PER_THREAD,
+                         image_size.height / MIN_BAND_ROWS);
+    num_bands = std::max(num_bands, 1);
+  }
+  const int band_rows = (image_size.height + num_bands - 1) / num_bands;
+  num_bands = (image_size.height + band_rows - 1) / band_rows;
+
+  // scan the bands, each one on its own
+  std::vector<RunBand> bands(num_bands);
+  BandScanner band_scanner(inputImage,
+                           maskImage,
+                           foreground,
+                           band_rows,
+                           workspace,
+                           bands);
+  if (num_bands > 1)
+  {
+    initScanlineSkip();
+    cv::parallel_for_(cv::Range(0, num_bands), band_scanner);
+  }
+  else
+  {
+    band_scanner(cv::Range(0, num_bands));
+  }
+
+  // concatenate the bands in raster order, the smallest index of every set
+  // stays its root
+  std::vector<PixelRun> runs;
+  RunSets run_sets;
+  std::vector<int> row_first_run(image_size.height + 1, 0);
+  std::vector<PixelRun> gaps;
+  RunSets gap_sets;
+  std::vector<int> row_first_gap(image_size.height + 1, 0);
+  std::vector<char> gap_on_border;
+  for (int i = 0; i < num_bands; ++i)
+  {
+    RunBand& band = bands[i];
+    const int row_begin = i * band_rows;
+    const int run_offset = static_cast<int>(runs.size());
+    const int gap_offset = static_cast<int>(gaps.size());
+    for (std::size_t row = 0; row < band.row_first_run.size(); ++row)
+    {
+      row_first_run[row_begin + row] = band.row_first_run[row] + run_offset;
+      row_first_gap[row_begin + row] = band.row_first_gap[row] + gap_offset;
+    }
+
+    if (i == 0)
+    {
+      runs.swap(band.runs);
+      run_sets.swap(band.run_sets);
+      gaps.swap(band.gaps);
+      gap_sets.swap(band.gap_sets);
+      gap_on_border.swap(band.gap_on_border);
+    }
+    else
+    {
+      runs.insert(runs.end(), band.runs.begin(), band.runs.end());
+      run_sets.append(band.run_sets);
+      gaps.insert(gaps.end(), band.gaps.begin(), band.gaps.end());
+      gap_sets.append(band.gap_sets);
+      gap_on_border.insert(gap_on_border.end(),
+                           band.gap_on_border.begin(),
+                           band.gap_on_border.end());
+    }
+  }
+  row_first_run[image_size.height] = static_cast<int>(runs.size());
+  row_first_gap[image_size.height] = static_cast<int>(gaps.size());
+
+  // join the runs and gaps across the seams between the bands
+  for (int row = band_rows; row < image_size.height; row += band_rows)
+  {
+    mergeRows(runs,
+              row_first_run[row - 1],
+              row_first_run[row],
+              row_first_run[row + 1],
+              1, // 8-connected foreground
+              run_sets);
+    mergeRows(gaps,
+              row_first_gap[row - 1],
+              row_first_gap[row],
+              row_first_gap[row + 1],
+              0, // 4-connected background
+              gap_sets);
+  }
+
+  // a background region is on the border if any of its gaps is
+  for (std::size_t i = 0; i < gaps.size(); ++i)
+  {
+    if (gap_on_border[i])
+    {
+      gap_on_border[gap_sets.find(static_cast<int>(i))] = true;
+    }
+  }
+
+  std::vector<ContourJob> jobs;
+
+  // label the components in raster order of their first run, which is the
+  // order the contour tracing algorithm discovers them in
+  const std::size_t first_blob = blobs.size();
+  std::vector<LabelType> run_labels(runs.size(), 0);
+  LabelType current_label = 1;
+  for (std::size_t i = 0; i < runs.size(); ++i)
+  {
+    const int root = run_sets.find(static_cast<int>(i));
+    if (root != static_cast<int>(i))
+    {
+      run_labels[i] = run_labels[root];
+      continue;
+    }
+    run_labels[i] = current_label;
+
+    // the first run of a component starts its external contour
+    ContourJob job;
+    job.start = cv::Point(runs[i].start, runs[i].row);
+    job.label = current_label;
+    job.b_internal = false;
+    cv::Ptr<Blob> p_blob =
+        workspace.createBlob(current_label, job.start, image_size);
+    job.contour = p_blob->externalContour();
+    jobs.push_back(job);
+    blobs.push_back(p_blob);
+    ++current_label;
+  }
+
+  // the pixel moments of a component are the sums of the ones of its runs
+  if (bAccumulateMoments)
+  {
+    std::vector<PixelMoments> label_moments(current_label - 1);
+    for (std::size_t i = 0; i < runs.size(); ++i)
+    {
+      label_moments[run_labels[i] - 1].addRun(runs[i].row,
+                                              runs[i].start,
+                                              runs[i].end);
+    }
+    for (std::size_t i = 0; i < label_moments.size(); ++i)
+    {
+      blobs[first_blob + i]->setPixelMoments(label_moments[i]);
+    }
+  }
+
+  // every background region that doesn't reach the image border is a hole.
+  // Its internal contour starts at the foreground pixel above the first
+  // pixel of the hole, holes are added in raster order of that pixel.
+  for (std::size_t i = 0; i < gaps.size(); ++i)
+  {
+    if (gap_on_border[i] ||
+        gap_sets.find(static_cast<int>(i)) != static_cast<int>(i))
+    {
+      continue;
+    }
+
+    ContourJob job;
+    job.start = cv::Point(gaps[i].start, gaps[i].row - 1);
+    const int run_index = findRunContaining(runs,
+                                            row_first_run[job.start.y],
+                                            row_first_run[job.start.y + 1],
+                                            job.start.x);
+    job.label = run_labels[run_index];
+    job.b_internal = true;
+    job.contour = workspace.createContour(job.start);
+    blobs[first_blob + job.label - 1]->addInternalContour(job.contour);
+    jobs.push_back(job);
+  }
+
+  if (pLabelImage != NULL && !runs.empty())
+  {
+    RunPainter run_painter(runs,
+                           run_labels,
+                           row_first_run,
+                           band_rows,
+                           workspace);
+    const cv::Range band_range(0, num_bands);
+    if (num_bands > 1)
+    {
+      cv::parallel_for_(band_range, run_painter);
+    }
+    else
+    {
+      run_painter(band_range);
+    }
+    // the next labeling with this workspace clears what has been painted
+    workspace.markDirty(runs.front().row, runs.back().row + 1);
+  }
+
+  // trace the contours of the known components
+  ContourTracer contour_tracer(workspace, jobs);
+  const cv::Range job_range(0, static_cast<int>(jobs.size()));
+  if (num_bands > 1)
+  {
+    cv::parallel_for_(job_range, contour_tracer);
+  }
+  else
+  {
+    contour_tracer(job_range);
+  }
+
+  if (pLabelImage != NULL)
+  {
+    *pLabelImage = workspace.labelImage();
+  }
+
+  return true;
+}
+
+} // end anonymous namespace
+
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       bool bParallel /* = false */,
+                       bool bAccumulateMoments /* = false */)
+{
+  // scratch buffers only used by this call
+  LabelingWorkspace workspace;
+  return labelRuns(inputImage,
+                   maskImage,
+                   foreground,
+                   blobs,
+                   workspace,
+                   NULL, // no label image
+                   bParallel,
+                   bAccumulateMoments);
+}
+
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       bool bParallel /* = false */,
+                       bool bAccumulateMoments /* = false */)
+{
+  return labelRuns(inputImage,
+                   maskImage,
+                   foreground,
+                   blobs,
+                   workspace,
+                   NULL, // no label image
+                   bParallel,
+                   bAccumulateMoments);
+}
+
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       cv::Mat& labelImage,
+                       bool bParallel /* = false */,
+                       bool bAccumulateMoments /* = false */)
+{
+  // the label image keeps the buffer alive once the workspace is gone
+  LabelingWorkspace workspace;
+  return labelRuns(inputImage,
+                   maskImage,
+                   foreground,
+                   blobs,
+                   workspace,
+                   &labelImage,
+                   bParallel,
+                   bAccumulateMoments);
+}
+
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       cv::Mat& labelImage,
+                       bool bParallel /* = false */,
+                       bool bAccumulateMoments /* = false */)
+{
+  return labelRuns(inputImage,
+                   maskImage,
+                   foreground,
+                   blobs,
+                   workspace,
+                   &labelImage,
+                   bParallel,
+                   bAccumulateMoments);
+}
+
+CVBLOBS_END_NAMESPACE
@@ -0,0 +1,85 @@
+/**
+ * @brief Run-length connected components labelling (ie blobbing).
+ */
+#ifndef _CVBLOBS2_RUNLENGTHLABELING_H_
+#define _CVBLOBS2_RUNLENGTHLABELING_H_
+
+#include <cvblobs2/CvBlobsFwd.h>
+#include <cvblobs2/PixelCondition.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Labels \p inputImage by scanning each row into runs of foreground
+ * pixels and resolving the equivalences between runs of adjacent rows with a
+ * union-find.
+ *
+ * Every pixel is read exactly once and in memory order. Once the components
+ * are known only their contours are traced, so the produced blobs are the same
+ * blobs, with the same ids and the same contours, as the ones produced by the
+ * contour tracing algorithm of ComponentLabeling().
+ *
+ * When \p bParallel is true the image is split into horizontal bands that are
+ * scanned on their own threads, the runs on both sides of the seams between
+ * bands are then joined and the contours are traced in parallel too. Labels are
+ * always given in raster order of the components, so the result doesn't
+ * depend on the number of bands or threads.
+ *
+ * Foreground pixels are 8-connected, background pixels are 4-connected.
+ * Pixels equal to 0 in \p maskImage are treated as background.
+ *
+ * @param inputImage image to label, must be non-empty and CV_8UC1, CV_16UC1
+ * or CV_32FC1
+ * @param maskImage optional CV_8UC1 mask, empty or the same size as
+ * \p inputImage
+ * @param foreground selects the foreground pixels, a background color or a
+ * threshold, see PixelCondition
+ * @param blobs the found blobs are appended to this container in id order
+ * @param bParallel split the work between the threads of cv::parallel_for_
+ * @param bAccumulateMoments compute the pixel moments of every blob from its
+ * runs, see Blob::setPixelMoments()
+ * @return false if the image or the mask aren't valid
+ */
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       bool bParallel = false,
+                       bool bAccumulateMoments = false);
+
+/**
+ * @brief Same as above but the scratch buffers are taken from \p workspace.
+ */
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       bool bParallel = false,
+                       bool bAccumulateMoments = false);
+
+/**
+ * @brief Same as above and also returns the labelled image, see
+ * ComponentLabeling(). The runs of every component are painted with its label,
+ * which costs one write per foreground pixel.
+ */
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       cv::Mat& labelImage,
+                       bool bParallel = false,
+                       bool bAccumulateMoments = false);
+
+bool runLengthLabeling(const cv::Mat& inputImage,
+                       const cv::Mat& maskImage,
+                       const PixelCondition& foreground,
+                       BlobContainerType& blobs,
+                       LabelingWorkspace& workspace,
+                       cv::Mat& labelImage,
+                       bool bParallel = false,
+                       bool bAccumulateMoments = false);
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_RUNLENGTHLABELING_H_
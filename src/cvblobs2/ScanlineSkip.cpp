@@ -0,0 +1,239 @@
+#include <cvblobs2/ScanlineSkip.h>
+#include <cvblobs2/ScanlineSkipKernels.h>
+
+#include <opencv2/core/core.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define CVBLOBS_HAVE_SSE2
+#  include <emmintrin.h>
+#endif
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! implementations of the row search, picked once at runtime
+enum SkipImplementation
+{
+  SKIP_UNKNOWN = 0,
+  SKIP_SCALAR  = 1,
+  SKIP_SSE2    = 2,
+  SKIP_AVX2    = 3
+};
+
+int detectSkipImplementation()
+{
+#if defined(CVBLOBS_HAVE_AVX2) && defined(CV_CPU_AVX2)
+  if (cv::checkHardwareSupport(CV_CPU_AVX2))
+  {
+    return SKIP_AVX2;
+  }
+#endif
+#ifdef CVBLOBS_HAVE_SSE2
+  if (cv::checkHardwareSupport(CV_CPU_SSE2))
+  {
+    return SKIP_SSE2;
+  }
+#endif
+  return SKIP_SCALAR;
+}
+
+//! Returns the detected implementation. The static is initialized once, by
+//! the first caller; initScanlineSkip() makes that the thread handing rows to
+//! the workers so compilers without thread-safe statics are fine too.
+inline int skipImplementation()
+{
+  static const int implementation = detectSkipImplementation();
+  return implementation;
+}
+
+#ifdef CVBLOBS_HAVE_SSE2
+
+//! Returns one bit per pixel of the 16 pixels at \p col, set for background
+inline unsigned int backgroundBitsSse2(const unsigned char* pInputRow,
+                                       const unsigned char* pMaskRow,
+                                       int col,
+                                       const __m128i& background)
+{
+  __m128i is_background =
+      _mm_cmpeq_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInputRow + col)),
+          background);
+  if (pMaskRow != NULL)
+  {
+    const __m128i is_masked =
+        _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(pMaskRow + col)),
+            _mm_setzero_si128());
+    is_background = _mm_or_si128(is_background, is_masked);
+  }
+  return static_cast<unsigned int>(_mm_movemask_epi8(is_background));
+}
+
+int findForegroundColumnSse2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor)
+{
+  const __m128i background = _mm_set1_epi8(static_cast<char>(backgroundColor));
+  for (; col + 16 <= width; col += 16)
+  {
+    const unsigned int foreground_bits =
+        ~backgroundBitsSse2(pInputRow, pMaskRow, col, background) & 0xFFFFu;
+    if (foreground_bits != 0)
+    {
+      return col + lowestSetBit(foreground_bits);
+    }
+  }
+  return findForegroundColumnScalar(pInputRow,
+                                    pMaskRow,
+                                    col,
+                                    width,
+                                    backgroundColor);
+}
+
+int findBackgroundColumnSse2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor)
+{
+  const __m128i background = _mm_set1_epi8(static_cast<char>(backgroundColor));
+  for (; col + 16 <= width; col += 16)
+  {
+    const unsigned int background_bits =
+        backgroundBitsSse2(pInputRow, pMaskRow, col, background);
+    if (background_bits != 0)
+    {
+      return col + lowestSetBit(background_bits);
+    }
+  }
+  return findBackgroundColumnScalar(pInputRow,
+                                    pMaskRow,
+                                    col,
+                                    width,
+                                    backgroundColor);
+}
+
+int findFlaggedColumnSse2(const unsigned char* pRow,
+                          int col,
+                          int width,
+                          unsigned char flags)
+{
+  const __m128i flag_bits = _mm_set1_epi8(static_cast<char>(flags));
+  for (; col + 16 <= width; col += 16)
+  {
+    const __m128i is_clear =
+        _mm_cmpeq_epi8(
+            _mm_and_si128(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow + col)),
+                flag_bits),
+            _mm_setzero_si128());
+    const unsigned int flagged_bits =
+        ~static_cast<unsigned int>(_mm_movemask_epi8(is_clear)) & 0xFFFFu;
+    if (flagged_bits != 0)
+    {
+      return col + lowestSetBit(flagged_bits);
+    }
+  }
+  return findFlaggedColumnScalar(pRow, col, width, flags);
+}
+
+#endif // CVBLOBS_HAVE_SSE2
+
+} // end anonymous namespace
+
+void initScanlineSkip()
+{
+  skipImplementation();
+}
+
+int findForegroundColumn(const unsigned char* pInputRow,
+                         const unsigned char* pMaskRow,
+                         int col,
+                         int width,
+                         unsigned char backgroundColor)
+{
+  switch (skipImplementation())
+  {
+#ifdef CVBLOBS_HAVE_AVX2
+    case SKIP_AVX2:
+      return findForegroundColumnAvx2(pInputRow,
+                                      pMaskRow,
+                                      col,
+                                      width,
+                                      backgroundColor);
+#endif
+#ifdef CVBLOBS_HAVE_SSE2
+    case SKIP_SSE2:
+      return findForegroundColumnSse2(pInputRow,
+                                      pMaskRow,
+                                      col,
+                                      width,
+                                      backgroundColor);
+#endif
+    default:
+      return findForegroundColumnScalar(pInputRow,
+                                        pMaskRow,
+                                        col,
+                                        width,
+                                        backgroundColor);
+  }
+}
+
+int findBackgroundColumn(const unsigned char* pInputRow,
+                         const unsigned char* pMaskRow,
+                         int col,
+                         int width,
+                         unsigned char backgroundColor)
+{
+  switch (skipImplementation())
+  {
+#ifdef CVBLOBS_HAVE_AVX2
+    case SKIP_AVX2:
+      return findBackgroundColumnAvx2(pInputRow,
+                                      pMaskRow,
+                                      col,
+                                      width,
+                                      backgroundColor);
+#endif
+#ifdef CVBLOBS_HAVE_SSE2
+    case SKIP_SSE2:
+      return findBackgroundColumnSse2(pInputRow,
+                                      pMaskRow,
+                                      col,
+                                      width,
+                                      backgroundColor);
+#endif
+    default:
+      return findBackgroundColumnScalar(pInputRow,
+                                        pMaskRow,
+                                        col,
+                                        width,
+                                        backgroundColor);
+  }
+}
+
+int findFlaggedColumn(const unsigned char* pRow,
+                      int col,
+                      int width,
+                      unsigned char flags)
+{
+  switch (skipImplementation())
+  {
+#ifdef CVBLOBS_HAVE_AVX2
+    case SKIP_AVX2:
+      return findFlaggedColumnAvx2(pRow, col, width, flags);
+#endif
+#ifdef CVBLOBS_HAVE_SSE2
+    case SKIP_SSE2:
+      return findFlaggedColumnSse2(pRow, col, width, flags);
+#endif
+    default:
+      return findFlaggedColumnScalar(pRow, col, width, flags);
+  }
+}
+
+CVBLOBS_END_NAMESPACE
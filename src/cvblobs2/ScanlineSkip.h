@@ -0,0 +1,59 @@
+/**
+ * @brief Vectorized search for the next foreground or background pixel of an
+ * image row.
+ */
+#ifndef _CVBLOBS2_SCANLINESKIP_H_
+#define _CVBLOBS2_SCANLINESKIP_H_
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+/**
+ * @brief Picks the row search implementation the CPU supports, once.
+ *
+ * The functions below do it on their first call. Call this before running
+ * them on several threads, such as the bands of cv::parallel_for_, so the
+ * workers only read the implementation.
+ */
+void initScanlineSkip();
+
+/**
+ * @brief Returns the first column in [col, width) of a row that is foreground,
+ * or width if there is none.
+ *
+ * A pixel is foreground when it differs from \p backgroundColor and its mask
+ * pixel isn't 0. The row is checked 32 pixels at a time with AVX2 or 16 pixels
+ * at a time with SSE2, whichever the CPU supports, else one pixel at a time.
+ * @param pInputRow first pixel of the image row
+ * @param pMaskRow first pixel of the mask row, NULL when there is no mask
+ */
+int findForegroundColumn(const unsigned char* pInputRow,
+                         const unsigned char* pMaskRow,
+                         int col,
+                         int width,
+                         unsigned char backgroundColor);
+
+/**
+ * @brief Returns the first column in [col, width) of a row that is background,
+ * or width if there is none. See findForegroundColumn().
+ */
+int findBackgroundColumn(const unsigned char* pInputRow,
+                         const unsigned char* pMaskRow,
+                         int col,
+                         int width,
+                         unsigned char backgroundColor);
+
+/**
+ * @brief Returns the first column in [col, width) of a row whose pixel has
+ * any bit of \p flags set, or width if there is none.
+ * Used on bit field images such as the foreground map of LabelingWorkspace.
+ */
+int findFlaggedColumn(const unsigned char* pRow,
+                      int col,
+                      int width,
+                      unsigned char flags);
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_SCANLINESKIP_H_
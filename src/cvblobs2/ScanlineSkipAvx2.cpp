@@ -0,0 +1,117 @@
+/**
+ * @brief AVX2 versions of the row search. This is the only file compiled
+ * with AVX2 enabled (see CMakeLists.txt), its functions are only called once
+ * the CPU is known to support AVX2.
+ */
+#include <cvblobs2/ScanlineSkip.h>
+#include <cvblobs2/ScanlineSkipKernels.h>
+
+#ifdef CVBLOBS_HAVE_AVX2
+
+#include <immintrin.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+namespace {
+
+//! Returns one bit per pixel of the 32 pixels at \p col, set for background
+inline unsigned int backgroundBitsAvx2(const unsigned char* pInputRow,
+                                       const unsigned char* pMaskRow,
+                                       int col,
+                                       const __m256i& background)
+{
+  __m256i is_background =
+      _mm256_cmpeq_epi8(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pInputRow + col)),
+          background);
+  if (pMaskRow != NULL)
+  {
+    const __m256i is_masked =
+        _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pMaskRow + col)),
+            _mm256_setzero_si256());
+    is_background = _mm256_or_si256(is_background, is_masked);
+  }
+  return static_cast<unsigned int>(_mm256_movemask_epi8(is_background));
+}
+
+} // end anonymous namespace
+
+int findForegroundColumnAvx2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor)
+{
+  const __m256i background =
+      _mm256_set1_epi8(static_cast<char>(backgroundColor));
+  for (; col + 32 <= width; col += 32)
+  {
+    const unsigned int foreground_bits =
+        ~backgroundBitsAvx2(pInputRow, pMaskRow, col, background);
+    if (foreground_bits != 0)
+    {
+      return col + lowestSetBit(foreground_bits);
+    }
+  }
+  // less than 32 pixels left
+  return findForegroundColumnScalar(pInputRow,
+                                    pMaskRow,
+                                    col,
+                                    width,
+                                    backgroundColor);
+}
+
+int findBackgroundColumnAvx2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor)
+{
+  const __m256i background =
+      _mm256_set1_epi8(static_cast<char>(backgroundColor));
+  for (; col + 32 <= width; col += 32)
+  {
+    const unsigned int background_bits =
+        backgroundBitsAvx2(pInputRow, pMaskRow, col, background);
+    if (background_bits != 0)
+    {
+      return col + lowestSetBit(background_bits);
+    }
+  }
+  // less than 32 pixels left
+  return findBackgroundColumnScalar(pInputRow,
+                                    pMaskRow,
+                                    col,
+                                    width,
+                                    backgroundColor);
+}
+
+int findFlaggedColumnAvx2(const unsigned char* pRow,
+                          int col,
+                          int width,
+                          unsigned char flags)
+{
+  const __m256i flag_bits = _mm256_set1_epi8(static_cast<char>(flags));
+  for (; col + 32 <= width; col += 32)
+  {
+    const __m256i is_clear =
+        _mm256_cmpeq_epi8(
+            _mm256_and_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pRow + col)),
+                flag_bits),
+            _mm256_setzero_si256());
+    const unsigned int flagged_bits =
+        ~static_cast<unsigned int>(_mm256_movemask_epi8(is_clear));
+    if (flagged_bits != 0)
+    {
+      return col + lowestSetBit(flagged_bits);
+    }
+  }
+  // less than 32 pixels left
+  return findFlaggedColumnScalar(pRow, col, width, flags);
+}
+
+CVBLOBS_END_NAMESPACE
+
+#endif // CVBLOBS_HAVE_AVX2
@@ -0,0 +1,105 @@
+/**
+ * @brief Helpers shared by the scalar, SSE2 and AVX2 row searches of
+ * ScanlineSkip.h. Only included by their implementation files.
+ */
+#ifndef _CVBLOBS2_SCANLINESKIPKERNELS_H_
+#define _CVBLOBS2_SCANLINESKIPKERNELS_H_
+
+#include <cstddef>
+
+#include <cvblobs2/CvBlobsFwd.h>
+
+CVBLOBS_BEGIN_NAMESPACE
+
+//! Returns true if the pixel \p col of the row is background: equal to
+//! \p backgroundColor, or 0 in the mask row when there is one
+inline bool IS_BACKGROUND_PIXEL(const unsigned char* pInputRow,
+                                const unsigned char* pMaskRow,
+                                int col,
+                                unsigned char backgroundColor)
+{
+  return pInputRow[col] == backgroundColor ||
+      (pMaskRow != NULL && pMaskRow[col] == 0);
+}
+
+//! One pixel at a time version of findForegroundColumn(), also used for
+//! the pixels left after the vectorized loops
+inline int findForegroundColumnScalar(const unsigned char* pInputRow,
+                                      const unsigned char* pMaskRow,
+                                      int col,
+                                      int width,
+                                      unsigned char backgroundColor)
+{
+  while (col < width &&
+         IS_BACKGROUND_PIXEL(pInputRow, pMaskRow, col, backgroundColor))
+  {
+    ++col;
+  }
+  return col;
+}
+
+//! One pixel at a time version of findBackgroundColumn()
+inline int findBackgroundColumnScalar(const unsigned char* pInputRow,
+                                      const unsigned char* pMaskRow,
+                                      int col,
+                                      int width,
+                                      unsigned char backgroundColor)
+{
+  while (col < width &&
+         !IS_BACKGROUND_PIXEL(pInputRow, pMaskRow, col, backgroundColor))
+  {
+    ++col;
+  }
+  return col;
+}
+
+//! One pixel at a time version of findFlaggedColumn()
+inline int findFlaggedColumnScalar(const unsigned char* pRow,
+                                   int col,
+                                   int width,
+                                   unsigned char flags)
+{
+  while (col < width && (pRow[col] & flags) == 0)
+  {
+    ++col;
+  }
+  return col;
+}
+
+//! Returns the index of the lowest bit set in \p bits, which can't be 0
+inline int lowestSetBit(unsigned int bits)
+{
+#if defined(__GNUC__)
+  return __builtin_ctz(bits);
+#else
+  int index = 0;
+  while ((bits & 1u) == 0)
+  {
+    bits >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+//! AVX2 versions, only defined when the library is built with AVX2 support
+int findForegroundColumnAvx2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor);
+
+int findBackgroundColumnAvx2(const unsigned char* pInputRow,
+                             const unsigned char* pMaskRow,
+                             int col,
+                             int width,
+                             unsigned char backgroundColor);
+
+int findFlaggedColumnAvx2(const unsigned char* pRow,
+                          int col,
+                          int width,
+                          unsigned char flags);
+
+CVBLOBS_END_NAMESPACE
+
+#endif // _CVBLOBS2_SCANLINESKIPKERNELS_H_
@@ -5,6 +5,13 @@
 #include <cvblobs2/SpatialMoments.h>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include <algorithm>
+#include <limits>
+
+#if CVBLOBS_MAX_MOMENTS_ORDER > 3
+#  error "PixelMoments only has closed forms of the power sums up to order 3"
+#endif
+
 CVBLOBS_BEGIN_NAMESPACE
 
 double spatialMoment(const cv::Moments& moments, int p, int q)
@@ -29,6 +36,8 @@ double spatialMoment(const cv::Moments& moments, int p, int q)
           return moments.m01;
         case 2:
           return moments.m02;
+        case 3:
+          return moments.m03;
       }
       break;
     case 1: // moments m1q
@@ -62,5 +71,95 @@ double spatialMoment(const cv::Moments& moments, int p, int q)
   return -1.0;
 }
 
+namespace {
+
+/**
+ * @brief Writes sum(x^k) for x in [0, n) and k in [0, 3] to \p pSums
+ */
+inline void POWER_SUMS(double n, double* pSums)
+{
+  pSums[0] = n;
+  pSums[1] = n * (n - 1.0) / 2.0;
+  pSums[2] = (n - 1.0) * n * (2.0 * n - 1.0) / 6.0;
+  pSums[3] = pSums[1] * pSums[1];
+}
+
+} // end anonymous namespace
+
+PixelMoments::PixelMoments()
+    : mMinX(std::numeric_limits<int>::max()),
+      mMinY(std::numeric_limits<int>::max()),
+      mMaxX(std::numeric_limits<int>::min()),
+      mMaxY(std::numeric_limits<int>::min())
+{
+  std::fill(&mMoments[0][0],
+            &mMoments[0][0] + sizeof(mMoments) / sizeof(mMoments[0][0]),
+            0.0);
+}
+
+void PixelMoments::addRun(int row, int colBegin, int colEnd)
+{
+  if (colEnd <= colBegin)
+  {
+    return;
+  }
+
+  // sums of the powers of the columns of the run
+  double end_sums[CVBLOBS_MAX_MOMENTS_ORDER + 1];
+  double begin_sums[CVBLOBS_MAX_MOMENTS_ORDER + 1];
+  POWER_SUMS(colEnd, end_sums);
+  POWER_SUMS(colBegin, begin_sums);
+
+  double row_power = 1.0;
+  for (int q = 0; q <= CVBLOBS_MAX_MOMENTS_ORDER; ++q)
+  {
+    for (int p = 0; p + q <= CVBLOBS_MAX_MOMENTS_ORDER; ++p)
+    {
+      mMoments[p][q] += (end_sums[p] - begin_sums[p]) * row_power;
+    }
+    row_power *= row;
+  }
+
+  mMinX = std::min(mMinX, colBegin);
+  mMaxX = std::max(mMaxX, colEnd - 1);
+  mMinY = std::min(mMinY, row);
+  mMaxY = std::max(mMaxY, row);
+}
+
+void PixelMoments::add(const PixelMoments& other)
+{
+  for (int p = 0; p <= CVBLOBS_MAX_MOMENTS_ORDER; ++p)
+  {
+    for (int q = 0; p + q <= CVBLOBS_MAX_MOMENTS_ORDER; ++q)
+    {
+      mMoments[p][q] += other.mMoments[p][q];
+    }
+  }
+  mMinX = std::min(mMinX, other.mMinX);
+  mMinY = std::min(mMinY, other.mMinY);
+  mMaxX = std::max(mMaxX, other.mMaxX);
+  mMaxY = std::max(mMaxY, other.mMaxY);
+}
+
+double PixelMoments::moment(int p, int q) const
+{
+  if (p < 0 ||
+      q < 0 ||
+      p + q > CVBLOBS_MAX_MOMENTS_ORDER)
+  {
+    return -1.0;
+  }
+  return mMoments[p][q];
+}
+
+cv::Rect PixelMoments::boundingBox() const
+{
+  if (isEmpty())
+  {
+    return cv::Rect();
+  }
+  return cv::Rect(mMinX, mMinY, mMaxX - mMinX + 1, mMaxY - mMinY + 1);
+}
+
 CVBLOBS_END_NAMESPACE
 
@@ -1,5 +1,5 @@
 /**
- * @brief @todo
+ * @brief Helpers to compute the spatial moments of contours and pixel sets
  * @author Nick Maludy <nmaludy@gmail.com>
  * @date 03/16/2014
  */
@@ -7,12 +7,88 @@
 #define _CVBLOBS2_SPATIALMOMENTS_H_
 
 #include <cvblobs2/CvBlobsFwd.h>
+#include <opencv2/core/core.hpp>
 
 CVBLOBS_BEGIN_NAMESPACE
 
 //! Get contour moment (p,q up to MAX_CALCULATED_MOMENTS)
 double spatialMoment(const cv::Moments& moments, int p, int q);
 
+/**
+ * @class PixelMoments
+ * @brief Area, bounding box and raw moments up to CVBLOBS_MAX_MOMENTS_ORDER of
+ * a set of pixels, accumulated one horizontal run of pixels at a time.
+ *
+ * The moments of a run are computed in closed form from the sums of the
+ * powers of its columns, so adding a run costs the same whatever its length.
+ * Unlike the moments of a BlobContour, which treat the contour as a polygon
+ * through the pixel centres, these count every pixel: moment(0, 0) is the
+ * number of pixels and moment(1, 0) / moment(0, 0) the mean column.
+ */
+class PixelMoments
+{
+ public:
+
+  /**
+   * @brief Creates the moments of an empty set of pixels
+   */
+  PixelMoments();
+
+  /**
+   * @brief Adds the pixels [colBegin, colEnd) of row \p row
+   */
+  void addRun(int row, int colBegin, int colEnd);
+
+  /**
+   * @brief Adds the pixels of \p other, which must not share any pixel with
+   * this set
+   */
+  void add(const PixelMoments& other);
+
+  /**
+   * @brief Returns true if no pixel has been added
+   */
+  inline bool isEmpty() const;
+
+  /**
+   * @brief Returns the number of pixels
+   */
+  inline double area() const;
+
+  /**
+   * @brief Returns the raw moment sum(x^p * y^q) over the pixels, or -1 if
+   * p + q is greater than CVBLOBS_MAX_MOMENTS_ORDER like spatialMoment()
+   */
+  double moment(int p, int q) const;
+
+  /**
+   * @brief Returns the smallest rectangle containing every pixel, an empty
+   * rectangle when there are no pixels
+   */
+  cv::Rect boundingBox() const;
+
+ private:
+
+  //! mMoments[p][q] is the raw moment (p, q), only p + q <= max order is used
+  double mMoments[CVBLOBS_MAX_MOMENTS_ORDER + 1][CVBLOBS_MAX_MOMENTS_ORDER + 1];
+
+  //! bounding box corners, inclusive
+  int mMinX;
+  int mMinY;
+  int mMaxX;
+  int mMaxY;
+};
+
+inline bool PixelMoments::isEmpty() const
+{
+  return mMoments[0][0] == 0;
+}
+
+inline double PixelMoments::area() const
+{
+  return mMoments[0][0];
+}
+
 CVBLOBS_END_NAMESPACE
 
 #endif // _CVBLOBS2_SPATIALMOMENTS_H_